@@ -1,3 +1,4 @@
+#include <cerrno>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -5,6 +6,11 @@
 #include "liburing.h"
 #include <sys/poll.h>
 
+#include "Histogram.h"
+#include "Log.h"
+#include "Topology.h"
+#include "Tsc.h"
+
 
 constexpr unsigned int BUF_SIZE = 4;
 constexpr unsigned int BUF_COUNT = 1024;
@@ -22,6 +28,7 @@ struct conn {
     char buf[BUF_SIZE];
     int buf_len;
     int closed;
+    uint64_t read_at;   // 读到请求时的 TSC，写完成时算延迟
 };
 
 struct io_uring_buf_ring *br;
@@ -33,6 +40,10 @@ static void fatal(const char *msg) {
 
 static struct conn conns[1024];
 
+// 读到请求到回应写完成的时间（TSC 周期），空闲超时的时候打印一次
+static stats::Histogram echo_latency;
+static uint64_t reported_count = 0;
+
 static void add_poll(io_uring *ring, int fd, unsigned poll_mask, __u64 user_data) {
     struct io_uring_sqe *sqe = io_uring_get_sqe(ring);
     if (!sqe) fatal("get sqe");
@@ -43,8 +54,15 @@ static void add_poll(io_uring *ring, int fd, unsigned poll_mask, __u64 user_data
     io_uring_submit(ring);
 }
 
-int main()
+int main(int argc, char** argv)
 {
+    topo::parse_args(argc, argv);
+    // accept 和收到数据的日志交给后台线程，不在事件循环里 printf。
+    // 在绑核之前启动，后台线程不继承事件循环的亲和性
+    alog::start();
+    // --pin=<策略> 时把事件循环线程绑到策略给的第一个 CPU 上
+    topo::pin_current(0, 1);
+
     int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
     if (listen_fd < 0) fatal("socket");
 
@@ -96,6 +114,13 @@ int main()
     while (1) {
         int ret = io_uring_wait_cqes(ring, &cqe, 1, &ts, NULL);
         if (ret < 0) {
+            if (ret == -ETIME) {
+                auto snap = echo_latency.snapshot();
+                if (snap.count() != reported_count) {
+                    reported_count = snap.count();
+                    snap.print(stdout, "echo_latency", "ns", stats::tsc_per_ns());
+                }
+            }
             continue;
         }
         do {
@@ -108,7 +133,7 @@ int main()
                 case OP_ACCEPT: {
                     int client_fd = cqe->res;
                     if (client_fd >= 0) {
-                        printf("→ new connection: fd=%d\n", client_fd);
+                        ALOG("→ new connection: fd=%d", client_fd);
 
                         fcntl(client_fd, F_SETFL, O_NONBLOCK);
 
@@ -151,8 +176,9 @@ int main()
                         }
                         break;
                     }
+                    conns[fd].read_at = stats::tsc_now();
                     conns[fd].buf[conns[fd].buf_len] ='\0';
-                    printf("收到 %d 字节: %s...\n", conns[fd].buf_len, conns[fd].buf);
+                    ALOG("收到 %d 字节: %s...", conns[fd].buf_len, std::string_view(conns[fd].buf, conns[fd].buf_len));
 
                     struct io_uring_sqe *sqe = io_uring_get_sqe(ring);
                     io_uring_prep_write(sqe, fd, conns[fd].buf, conns[fd].buf_len, 0);
@@ -168,6 +194,7 @@ int main()
 
                 case OP_WRITE: {
                     // 写完成，通常不用再做什么（如果缓冲区还有剩余可以继续写）
+                    if (cqe->res >= 0) echo_latency.record(stats::tsc_now() - conns[idx_or_fd].read_at);
                     break;
                 }
 
@@ -0,0 +1,108 @@
+#ifndef __ALLOC_OBJECTPOOL__
+#define __ALLOC_OBJECTPOOL__
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <utility>
+
+// 固定容量的对象池，对外给 32 位下标句柄而不是指针。
+//
+// 大对象经 MpmcRingBuffer 按值传递时，入队拷进槽位、出队再拷出来，槽位也跟着变大；
+// 改传 new 出来的指针又是每条消息一次 malloc / free。用对象池时队列里只放 4 字节的句柄，
+// 负载从构造到释放都待在池里原地不动，生产者写、消费者按句柄直接读。
+//
+//   存储    构造时一次分配 capacity 个槽位并预先写一遍（页在构造时就分配好），
+//           每个槽位按缓存行取整对齐，相邻对象不会共享缓存行
+//   空闲栈  Treiber 栈，栈顶是一个 64 位原子量：低 32 位是栈顶句柄，高 32 位是每次修改加一的标签，
+//           防止 ABA（线程 A 读到栈顶 x 和它的 next y，期间别的线程弹出 x、y 又压回 x，
+//           A 的 CAS 只比句柄的话会成功并把已被占用的 y 放回栈顶）。
+//           next 链放在单独的原子数组里，不写进对象的存储
+//
+// 任意线程都可以 emplace / release；同一个句柄由谁释放由使用者保证只有一次。
+// 池析构时不会析构仍未释放的对象
+namespace alloc {
+
+template<typename T>
+class ObjectPool {
+    static_assert(alignof(T) <= 64, "ObjectPool slots are cache-line aligned");
+
+public:
+    using Handle = uint32_t;
+    static constexpr Handle NIL = UINT32_MAX;
+
+    explicit ObjectPool(uint32_t capacity)
+        : capacity_(capacity),
+          storage_(static_cast<char*>(::operator new(size_t(capacity) * STRIDE, std::align_val_t(64)))),
+          next_(new std::atomic<Handle>[capacity]) {
+        memset(storage_, 0, size_t(capacity) * STRIDE);
+        for (Handle i = 0; i < capacity; ++i) {
+            next_[i].store(i + 1 < capacity ? i + 1 : NIL, std::memory_order_relaxed);
+        }
+        head_.store(capacity ? 0 : NIL, std::memory_order_relaxed);
+    }
+
+    ~ObjectPool() { ::operator delete(storage_, std::align_val_t(64)); }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // 取一个空闲槽位并原地构造，池空时返回 NIL
+    template<typename... Args>
+    Handle emplace(Args&&... args) {
+        Handle h = pop();
+        if (h != NIL) new (slot(h)) T(std::forward<Args>(args)...);
+        return h;
+    }
+
+    // 析构并归还
+    void release(Handle h) {
+        std::destroy_at(get(h));
+        push(h);
+    }
+
+    T& operator[](Handle h) { return *get(h); }
+    const T& operator[](Handle h) const { return *get(h); }
+
+    uint32_t capacity() const { return capacity_; }
+
+private:
+    static constexpr size_t STRIDE = (sizeof(T) + 63) / 64 * 64;
+
+    void* slot(Handle h) const { return storage_ + size_t(h) * STRIDE; }
+    T* get(Handle h) const { return std::launder(static_cast<T*>(slot(h))); }
+
+    static uint64_t pack(uint64_t tag, Handle h) { return tag << 32 | h; }
+
+    // acquire：和归还者的 release 配对，上一个使用者对槽位的写（包括析构）都先于这里的构造
+    Handle pop() {
+        uint64_t old = head_.load(std::memory_order_acquire);
+        while (true) {
+            const Handle h = Handle(old);
+            if (h == NIL) return NIL;
+            const Handle next = next_[h].load(std::memory_order_relaxed);
+            if (head_.compare_exchange_weak(old, pack((old >> 32) + 1, next), std::memory_order_acquire,
+                                            std::memory_order_acquire)) {
+                return h;
+            }
+        }
+    }
+
+    void push(Handle h) {
+        uint64_t old = head_.load(std::memory_order_relaxed);
+        do {
+            next_[h].store(Handle(old), std::memory_order_relaxed);
+        } while (!head_.compare_exchange_weak(old, pack((old >> 32) + 1, h), std::memory_order_release,
+                                              std::memory_order_relaxed));
+    }
+
+    const uint32_t capacity_;
+    char* const storage_;
+    const std::unique_ptr<std::atomic<Handle>[]> next_;
+    alignas(64) std::atomic<uint64_t> head_{0};
+};
+
+}  // namespace alloc
+
+#endif /* __ALLOC_OBJECTPOOL__ */
@@ -0,0 +1,157 @@
+#ifndef __ALLOC_SMALLALLOC__
+#define __ALLOC_SMALLALLOC__
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// 按尺寸分档的小对象分配器（<= 2K），替代队列负载、协程帧这类高频小块的 malloc。
+//
+//   线程缓存  每个线程一个 Heap，每档一条侵入式单链表，分配 / 释放自己的对象时没有原子操作
+//   中央链表  每档一个 MpmcRingBuffer，元素是一批对象（一条链 + 个数）。本地链表太长时整批交出去，
+//             本地空了先从这里整批取，线程间一次搬一批，而不是一个一个地争
+//   span      从 64M 的 mmap 区里切 64K 对齐的 span，开头是 SpanHeader（属主 Heap、档位），
+//             对象地址按 64K 取整就找到它
+//   跨线程释放 对象还给 span 的属主：先攒在本线程的 pending 链上，满一批或换了属主时
+//             一次 CAS 挂到属主的 remote 栈上；属主在慢路径里 exchange 整条取走
+//
+// 线程退出时把本地链表尽量交给中央链表，Heap 本身不销毁，留给下一个新线程接手（连同之后
+// 陆续还回来的 remote 对象），所以 SpanHeader 里的属主指针永远有效。span 不还给操作系统。
+//
+// 接口是带尺寸的：deallocate 必须传 allocate 时的 size，超过 MAX_SMALL_SIZE 的请求直接转给
+// ::operator new / delete，协程帧的 operator delete(void*, size_t) 正好满足
+namespace alloc {
+
+constexpr size_t MAX_SMALL_SIZE = 2048;
+constexpr size_t SPAN_BYTES = 64 << 10;
+constexpr size_t SPAN_HEADER_BYTES = 64;
+
+// 统计：至今从 mmap 区切出的 span 数
+size_t spans_mapped();
+
+namespace detail {
+
+// 16..128 每 16 字节一档，之后每个 2 的幂区间四档：160..256, 320..512, 640..1024, 1280..2048
+constexpr size_t CLASS_COUNT = 24;
+
+constexpr std::array<uint32_t, CLASS_COUNT> CLASS_SIZE = [] {
+    std::array<uint32_t, CLASS_COUNT> s{};
+    size_t n = 0;
+    for (uint32_t size = 16; size <= 128; size += 16) {
+        s[n++] = size;
+    }
+    for (uint32_t base = 128; base < MAX_SMALL_SIZE; base *= 2) {
+        for (uint32_t step = 1; step <= 4; ++step) {
+            s[n++] = base + step * base / 4;
+        }
+    }
+    return s;
+}();
+
+// 按 16 字节取整后查表
+constexpr std::array<uint8_t, MAX_SMALL_SIZE / 16 + 1> CLASS_OF = [] {
+    std::array<uint8_t, MAX_SMALL_SIZE / 16 + 1> t{};
+    size_t cls = 0;
+    for (size_t i = 0; i < t.size(); ++i) {
+        while (CLASS_SIZE[cls] < i * 16) {
+            ++cls;
+        }
+        t[i] = uint8_t(cls);
+    }
+    return t;
+}();
+
+inline unsigned class_of(size_t size) {
+    return CLASS_OF[(size + 15) >> 4];
+}
+
+// 一次在线程缓存和中央链表之间搬多少个：约 8K 字节，2 到 64 个
+constexpr uint32_t batch_of(unsigned cls) {
+    uint32_t n = uint32_t(8192 / CLASS_SIZE[cls]);
+    return n < 2 ? 2 : (n > 64 ? 64 : n);
+}
+
+struct Heap;
+
+struct SpanHeader {
+    Heap* owner;
+    uint32_t cls;
+};
+
+inline SpanHeader* span_of(void* p) {
+    return reinterpret_cast<SpanHeader*>(reinterpret_cast<uintptr_t>(p) & ~(SPAN_BYTES - 1));
+}
+
+inline void*& next_of(void* p) {
+    return *static_cast<void**>(p);
+}
+
+struct FreeList {
+    void* head = nullptr;
+    uint32_t count = 0;
+    uint32_t limit = 0;    // count 超过它就交一批给中央链表；中央链表满时翻倍退避
+    char* bump = nullptr;  // 当前 span 里还没切出去的部分
+    char* bump_end = nullptr;
+};
+
+// 本线程欠别的 Heap 的对象，同一个属主的攒成一条链再一起还
+struct PendingRemote {
+    Heap* owner = nullptr;
+    void* head = nullptr;
+    void* tail = nullptr;
+    uint32_t count = 0;
+};
+
+struct Heap {
+    Heap();
+
+    FreeList lists[CLASS_COUNT];
+    PendingRemote pending;
+    // 别的线程还回来的对象，MPSC：任意线程 CAS 压栈，属主 exchange 整条取走，没有 ABA
+    alignas(64) std::atomic<void*> remote{nullptr};
+};
+
+// 快路径只读这个可平凡初始化的 thread_local；为空时进慢路径挂上一个 Heap
+inline constinit thread_local Heap* tls_heap = nullptr;
+
+void* allocate_slow(unsigned cls);
+void release_batch(Heap* h, unsigned cls);
+void deallocate_slow(void* p, SpanHeader* span) noexcept;
+
+}  // namespace detail
+
+inline void* allocate(size_t size) {
+    if (size > MAX_SMALL_SIZE) [[unlikely]] return ::operator new(size);
+    const unsigned cls = detail::class_of(size);
+    if (detail::Heap* h = detail::tls_heap) [[likely]] {
+        detail::FreeList& fl = h->lists[cls];
+        if (void* p = fl.head) [[likely]] {
+            fl.head = detail::next_of(p);
+            --fl.count;
+            return p;
+        }
+    }
+    return detail::allocate_slow(cls);
+}
+
+inline void deallocate(void* p, size_t size) noexcept {
+    if (size > MAX_SMALL_SIZE) [[unlikely]] {
+        ::operator delete(p);
+        return;
+    }
+    detail::SpanHeader* span = detail::span_of(p);
+    detail::Heap* h = detail::tls_heap;
+    if (h && span->owner == h) [[likely]] {
+        detail::FreeList& fl = h->lists[span->cls];
+        detail::next_of(p) = fl.head;
+        fl.head = p;
+        if (++fl.count > fl.limit) [[unlikely]] detail::release_batch(h, span->cls);
+        return;
+    }
+    detail::deallocate_slow(p, span);
+}
+
+}  // namespace alloc
+
+#endif /* __ALLOC_SMALLALLOC__ */
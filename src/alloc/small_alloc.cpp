@@ -0,0 +1,292 @@
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "MpmcRingBuffer.h"
+#include "SmallAlloc.h"
+
+namespace alloc {
+
+namespace detail {
+
+namespace {
+
+constexpr size_t ARENA_BYTES = 64 << 20;
+// 每档中央链表最多存多少批
+constexpr size_t CENTRAL_BATCHES = 1024;
+// 欠同一个属主的对象攒到这么多再一起还
+constexpr uint32_t REMOTE_BATCH = 32;
+
+struct Batch {
+    void* head = nullptr;
+    uint32_t count = 0;
+};
+
+using CentralList = MpmcRingBuffer<Batch, CENTRAL_BATCHES>;
+
+// 下面的全局状态都用函数内静态变量：别的翻译单元的静态初始化里也可能分配
+CentralList& central(unsigned cls) {
+    static CentralList* lists = new CentralList[CLASS_COUNT];
+    return lists[cls];
+}
+
+struct Arena {
+    std::mutex mu;
+    char* cur = nullptr;
+    char* end = nullptr;
+    std::atomic<size_t> spans{0};
+};
+
+Arena& arena() {
+    static Arena* a = new Arena;
+    return *a;
+}
+
+// 一次映射 64M，多映射一个 span 的量再把首尾裁掉，得到 64K 对齐的区间
+char* new_span() {
+    Arena& a = arena();
+    std::lock_guard<std::mutex> lock(a.mu);
+    if (a.cur == a.end) {
+        const size_t len = ARENA_BYTES + SPAN_BYTES;
+        void* m = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (m == MAP_FAILED) throw std::bad_alloc();
+        char* raw = static_cast<char*>(m);
+        char* begin = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(raw) + SPAN_BYTES - 1) & ~(SPAN_BYTES - 1));
+        if (begin != raw) munmap(raw, begin - raw);
+        munmap(begin + ARENA_BYTES, raw + len - (begin + ARENA_BYTES));
+        a.cur = begin;
+        a.end = begin + ARENA_BYTES;
+    }
+    char* span = a.cur;
+    a.cur += SPAN_BYTES;
+    a.spans.fetch_add(1, std::memory_order_relaxed);
+    return span;
+}
+
+// 空闲的 Heap：线程退出时放回来，新线程优先接手
+struct Registry {
+    std::mutex mu;
+    std::vector<Heap*> idle;
+    size_t heaps = 0;  // 建过的 Heap 数；idle 预留这么多，线程退出时放回去不会再分配
+};
+
+Registry& registry() {
+    static Registry* r = new Registry;
+    return *r;
+}
+
+// 线程的 thread_local 析构之后还有分配 / 释放（别的 thread_local 的析构函数里）时用它，加锁访问
+struct Orphan {
+    std::mutex mu;
+    Heap heap;
+};
+
+Orphan& orphan() {
+    static Orphan* o = new Orphan;
+    return *o;
+}
+
+constinit thread_local bool tls_exited = false;
+
+void push_remote(Heap* owner, void* first, void* last) noexcept {
+    void* old = owner->remote.load(std::memory_order_relaxed);
+    do {
+        next_of(last) = old;
+    } while (!owner->remote.compare_exchange_weak(old, first, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void flush_pending(Heap* h) noexcept {
+    PendingRemote& pr = h->pending;
+    if (pr.count == 0) return;
+    push_remote(pr.owner, pr.head, pr.tail);
+    pr = PendingRemote{};
+}
+
+// 别的线程还回来的对象按各自的档位放回本地链表
+void drain_remote(Heap* h) {
+    void* p = h->remote.exchange(nullptr, std::memory_order_acquire);
+    while (p) {
+        void* next = next_of(p);
+        FreeList& fl = h->lists[span_of(p)->cls];
+        next_of(p) = fl.head;
+        fl.head = p;
+        ++fl.count;
+        p = next;
+    }
+}
+
+// 从当前 span 切一批对象出来，切完了先换一个新 span
+void carve(Heap* h, unsigned cls) {
+    FreeList& fl = h->lists[cls];
+    const size_t size = CLASS_SIZE[cls];
+    if (size_t(fl.bump_end - fl.bump) < size) {
+        char* span = new_span();
+        *reinterpret_cast<SpanHeader*>(span) = SpanHeader{h, cls};
+        fl.bump = span + SPAN_HEADER_BYTES;
+        fl.bump_end = fl.bump + (SPAN_BYTES - SPAN_HEADER_BYTES) / size * size;
+    }
+    // 倒着压栈，取出来的顺序就是地址递增的
+    size_t n = std::min<size_t>(batch_of(cls), size_t(fl.bump_end - fl.bump) / size);
+    for (size_t i = n; i-- > 0;) {
+        void* p = fl.bump + i * size;
+        next_of(p) = fl.head;
+        fl.head = p;
+    }
+    fl.count += uint32_t(n);
+    fl.bump += n * size;
+}
+
+void* refill(Heap* h, unsigned cls) {
+    FreeList& fl = h->lists[cls];
+    flush_pending(h);
+    if (h->remote.load(std::memory_order_relaxed)) drain_remote(h);
+    if (!fl.head) {
+        Batch b;
+        if (central(cls).try_pop(b)) {
+            fl.head = b.head;
+            fl.count = b.count;
+        }
+    }
+    if (!fl.head) carve(h, cls);
+    void* p = fl.head;
+    fl.head = next_of(p);
+    --fl.count;
+    return p;
+}
+
+// 从链表头摘下最多 n 个交给中央链表，中央链表满时接回去，返回是否交出
+bool push_central(Heap* h, unsigned cls, uint32_t n) {
+    FreeList& fl = h->lists[cls];
+    n = std::min(n, fl.count);
+    if (n == 0) return false;
+    void* head = fl.head;
+    void* last = head;
+    for (uint32_t i = 1; i < n; ++i) {
+        last = next_of(last);
+    }
+    void* rest = next_of(last);
+    next_of(last) = nullptr;
+    if (!central(cls).try_emplace(Batch{head, n})) {
+        next_of(last) = rest;
+        return false;
+    }
+    fl.head = rest;
+    fl.count -= n;
+    return true;
+}
+
+void detach_heap(Heap* h) {
+    flush_pending(h);
+    for (unsigned cls = 0; cls < CLASS_COUNT; ++cls) {
+        while (push_central(h, cls, batch_of(cls))) {
+        }
+    }
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mu);
+    r.idle.push_back(h);
+}
+
+struct HeapHolder {
+    Heap* heap;
+
+    HeapHolder() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mu);
+        if (r.idle.empty()) {
+            r.idle.reserve(r.heaps + 1);
+            // 故意泄漏：span 里记着属主指针
+            heap = new Heap;
+            ++r.heaps;
+        } else {
+            heap = r.idle.back();
+            r.idle.pop_back();
+        }
+    }
+
+    ~HeapHolder() {
+        tls_heap = nullptr;
+        tls_exited = true;
+        detach_heap(heap);
+    }
+};
+
+// 线程第一次进慢路径时挂上一个 Heap；线程已经在析构 thread_local 时返回 nullptr
+Heap* attach() {
+    if (tls_exited) return nullptr;
+    thread_local HeapHolder holder;
+    tls_heap = holder.heap;
+    return holder.heap;
+}
+
+// 释放路径不能抛：挂 Heap 时分配失败就当没挂上，和线程已经退出时一样处理，下次再试
+Heap* try_attach() noexcept {
+    try {
+        return attach();
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+}  // namespace
+
+Heap::Heap() {
+    for (unsigned cls = 0; cls < CLASS_COUNT; ++cls) {
+        lists[cls].limit = 2 * batch_of(cls);
+    }
+}
+
+void* allocate_slow(unsigned cls) {
+    Heap* h = tls_heap;
+    if (!h) h = attach();
+    if (!h) {
+        Orphan& o = orphan();
+        std::lock_guard<std::mutex> lock(o.mu);
+        return refill(&o.heap, cls);
+    }
+    return refill(h, cls);
+}
+
+void release_batch(Heap* h, unsigned cls) {
+    FreeList& fl = h->lists[cls];
+    if (push_central(h, cls, batch_of(cls))) {
+        fl.limit = 2 * batch_of(cls);
+    } else {
+        fl.limit *= 2;
+    }
+}
+
+void deallocate_slow(void* p, SpanHeader* span) noexcept {
+    Heap* h = tls_heap;
+    if (!h) h = try_attach();
+    if (!h) {
+        push_remote(span->owner, p, p);
+        return;
+    }
+    if (span->owner == h) {
+        FreeList& fl = h->lists[span->cls];
+        next_of(p) = fl.head;
+        fl.head = p;
+        if (++fl.count > fl.limit) release_batch(h, span->cls);
+        return;
+    }
+    PendingRemote& pr = h->pending;
+    if (pr.owner != span->owner) {
+        flush_pending(h);
+        pr.owner = span->owner;
+        pr.tail = p;
+    }
+    next_of(p) = pr.head;
+    pr.head = p;
+    if (++pr.count >= REMOTE_BATCH) flush_pending(h);
+}
+
+}  // namespace detail
+
+size_t spans_mapped() {
+    return detail::arena().spans.load(std::memory_order_relaxed);
+}
+
+}  // namespace alloc
@@ -0,0 +1,174 @@
+#ifndef __ALOG_LOG__
+#define __ALOG_LOG__
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unistd.h>
+
+#include "SpscRingBuffer.h"
+#include "Tsc.h"
+
+// 异步日志：服务程序热路径上的 printf 换成 ALOG(fmt, args...)。
+//
+//   调用线程  只打 TSC 时间戳，把格式串地址（当作格式 id）和参数按二进制拷进自己的 SpscRingBuffer 槽位，
+//             不格式化、不加锁、不进内核，几十纳秒。每条记录固定 128 字节：参数按 8 字节存，
+//             字符串（const char*、string_view、string）拷贝内容，放不下的部分截断
+//   后台线程  轮询所有线程的环，一轮取出的记录按时间戳排好，格式化到一块缓冲区里一次 write 出去；
+//             没有记录时最多睡 1ms
+//   溢出      Overflow::Drop 丢掉并按线程计数，后台线程会写一行丢了多少；Overflow::Block 等后台线程腾出位置
+//
+// 格式串必须是字面量，按 printf 的语法解释，长度修饰符可以省略（参数都按 64 位存）。
+// start 之前、stop 之后的记录按丢弃计数。stop 会把已经进环的记录全部写出，start 时注册了 atexit
+namespace alog {
+
+enum class Overflow {
+    Drop,
+    Block,
+};
+
+struct Options {
+    int fd = STDOUT_FILENO;
+    Overflow overflow = Overflow::Drop;
+};
+
+// 启动后台线程；已经在运行时什么也不做
+void start(const Options& options = {});
+
+// 写出所有已经进环的记录，停掉后台线程
+void stop();
+
+// 等到调用之前进环的记录都写出去
+void flush();
+
+// 至今丢弃的记录数
+uint64_t dropped();
+
+namespace detail {
+
+enum ArgType : uint32_t { END = 0, I64, U64, F64, PTR, STR };
+
+constexpr size_t RECORD_BYTES = 128;
+constexpr size_t MAX_ARGS = 8;
+constexpr size_t RING_RECORDS = 1024;
+
+struct Record {
+    uint64_t tsc;
+    const char* fmt;
+    uint32_t types;  // 第 i 个参数的 ArgType 在 [4i, 4i + 4) 位，END 结束
+    uint32_t bytes;  // payload 用了多少
+    char payload[RECORD_BYTES - 24];
+
+    Record() = default;
+
+    template<typename... Args>
+    explicit Record(const char* format, const Args&... args) : tsc(stats::tsc_now()), fmt(format), types(0), bytes(0) {
+        unsigned i = 0;
+        (put(i++, args), ...);
+    }
+
+    template<typename T>
+    void put(unsigned i, const T& v) {
+        using D = std::decay_t<T>;
+        if constexpr (std::is_same_v<D, std::string_view> || std::is_same_v<D, std::string>) {
+            put_str(i, v.data(), v.size());
+        } else if constexpr (std::is_convertible_v<const T&, const char*>) {
+            const char* s = v;
+            put_str(i, s, s ? strnlen(s, sizeof(payload)) : 0);
+        } else if constexpr (std::is_floating_point_v<D>) {
+            put_word(i, F64, std::bit_cast<uint64_t>(double(v)));
+        } else if constexpr (std::is_pointer_v<D>) {
+            put_word(i, PTR, uint64_t(reinterpret_cast<uintptr_t>(v)));
+        } else if constexpr (std::is_integral_v<D> || std::is_enum_v<D>) {
+            if constexpr (std::is_signed_v<D> || std::is_enum_v<D>) {
+                put_word(i, I64, uint64_t(int64_t(v)));
+            } else {
+                put_word(i, U64, uint64_t(v));
+            }
+        } else {
+            static_assert(std::is_integral_v<D>, "ALOG arguments: integers, floats, pointers, strings");
+        }
+    }
+
+    // 放不下的参数连同之后的都不存，格式化时打成 <?>
+    bool follows(unsigned i) const { return i == 0 || (types >> (4 * (i - 1)) & 0xF) != END; }
+
+    void put_word(unsigned i, ArgType type, uint64_t w) {
+        if (!follows(i) || bytes + sizeof(w) > sizeof(payload)) return;
+        memcpy(payload + bytes, &w, sizeof(w));
+        bytes += sizeof(w);
+        types |= type << (4 * i);
+    }
+
+    void put_str(unsigned i, const char* s, size_t len) {
+        if (!follows(i) || bytes + sizeof(uint16_t) > sizeof(payload)) return;
+        const uint16_t n = uint16_t(std::min(len, sizeof(payload) - bytes - sizeof(uint16_t)));
+        memcpy(payload + bytes, &n, sizeof(n));
+        memcpy(payload + bytes + sizeof(n), s, n);
+        bytes += sizeof(n) + n;
+        types |= STR << (4 * i);
+    }
+};
+static_assert(sizeof(Record) == RECORD_BYTES);
+
+struct Channel {
+    SpscRingBuffer<Record, RING_RECORDS> ring;
+    std::atomic<uint64_t> dropped{0};  // 只有所属线程写
+    std::atomic<uint64_t> pushed{0};   // 进环的记录数，只有所属线程写
+    std::atomic<uint64_t> written{0};  // 已经写出去的记录数，只有取记录的一方写；flush 等它追上 pushed
+    std::atomic<bool> retired{false};  // 线程退出时置位，后台线程取空后释放
+    uint64_t popped = 0;               // 已经取出的记录数
+    uint64_t reported = 0;             // 后台线程已经报告过的丢弃数
+    uint64_t serial = 0;               // 注册顺序，Channel 释放后地址可能被新的复用，flush 用它区分
+    int tid = 0;
+};
+
+enum Mode : int { STOPPED, DROP, BLOCK };
+inline constinit std::atomic<int> mode{STOPPED};
+
+// 快路径只读这个可平凡初始化的 thread_local；为空时进慢路径注册一个 Channel
+inline constinit thread_local Channel* tls_channel = nullptr;
+
+// 线程已经在析构 thread_local 时不再注册，返回 nullptr（这条记录已按丢弃计数）
+Channel* attach();
+// Block 时环满了：叫醒后台线程，等到有位置（或者日志停了）
+bool wait_for_space(Channel* ch);
+
+// 只有所属线程写，不需要 RMW
+inline void bump(std::atomic<uint64_t>& counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+template<typename... Args>
+void write(const char* fmt, const Args&... args) {
+    static_assert(sizeof...(Args) <= MAX_ARGS, "ALOG takes at most 8 arguments");
+    Channel* ch = tls_channel;
+    if (!ch) [[unlikely]] {
+        ch = attach();
+        if (!ch) return;
+    }
+    const int m = mode.load(std::memory_order_relaxed);
+    if (m == BLOCK && ch->ring.full() && !wait_for_space(ch)) [[unlikely]] {
+        bump(ch->dropped);
+        return;
+    }
+    if (m == STOPPED || !ch->ring.try_emplace(fmt, args...)) [[unlikely]] {
+        bump(ch->dropped);
+        return;
+    }
+    bump(ch->pushed);
+}
+
+}  // namespace detail
+
+}  // namespace alog
+
+// 字面量拼接保证格式串是字面量：后台线程格式化时它还得活着
+#define ALOG(fmt, ...) ::alog::detail::write("" fmt "" __VA_OPT__(, ) __VA_ARGS__)
+
+#endif /* __ALOG_LOG__ */
@@ -0,0 +1,434 @@
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <emmintrin.h>
+
+#include "Log.h"
+
+namespace alog {
+
+namespace detail {
+
+namespace {
+
+// 一轮最多从一个线程的环里取多少条，取完的槽位尽早还给生产者
+constexpr size_t DRAIN_BATCH = RING_RECORDS / 4;
+constexpr size_t FLUSH_BYTES = 64 << 10;
+constexpr auto IDLE_WAIT = std::chrono::milliseconds(1);
+
+// 后台线程和注册表的全部状态。故意泄漏：线程退出时的 retire、atexit 里的 stop 都可能晚于静态对象析构
+struct Logger {
+    std::mutex mu;
+    std::condition_variable wake;    // 叫醒后台线程：flush、Block 时环满、stop
+    std::condition_variable passed;  // 后台线程每取完一轮通知一次；stop 收尾完也通知
+    std::vector<Channel*> channels;
+    uint64_t retired_dropped = 0;  // 已释放的 Channel 丢过的记录，以及线程退出之后才写的记录
+    uint64_t next_serial = 0;
+    bool wake_requested = false;
+    bool stop_requested = false;
+    bool running = false;
+    bool stopping = false;  // 有一个 stop 拿走了后台线程，正在收尾；别的 start / stop 等它做完
+    std::thread thread;
+    Options options;
+
+    // 下面只有后台线程访问
+    uint64_t base_tsc = 0;
+    int64_t base_ns = 0;
+    double tsc_per_ns = 1.0;
+    time_t last_sec = -1;
+    char hms[16] = {};
+    std::vector<Channel*> scan;
+    std::vector<Channel*> dead;
+    std::vector<Record> batch;
+    std::vector<int> tids;
+    std::vector<uint32_t> order;
+    std::string out;
+};
+
+Logger& logger() {
+    static Logger* l = new Logger;
+    return *l;
+}
+
+void write_all(int fd, const char* p, size_t n) {
+    while (n > 0) {
+        const ssize_t w = ::write(fd, p, n);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        p += w;
+        n -= size_t(w);
+    }
+}
+
+struct Arg {
+    ArgType type = END;
+    uint64_t word = 0;
+    std::string_view str;
+};
+
+size_t decode(const Record& r, Arg (&args)[MAX_ARGS]) {
+    size_t n = 0, off = 0;
+    for (; n < MAX_ARGS; ++n) {
+        const auto type = ArgType(r.types >> (4 * n) & 0xF);
+        if (type == END) break;
+        args[n].type = type;
+        if (type == STR) {
+            uint16_t len;
+            memcpy(&len, r.payload + off, sizeof(len));
+            args[n].str = std::string_view(r.payload + off + sizeof(len), len);
+            off += sizeof(len) + len;
+        } else {
+            memcpy(&args[n].word, r.payload + off, sizeof(uint64_t));
+            off += sizeof(uint64_t);
+        }
+    }
+    return n;
+}
+
+// 按参数实际存的类型重写转换说明：spec 是 % 加上标志、宽度、精度（* 已经换成数字）
+void format_arg(std::string& out, std::string spec, char conv, const Arg* arg) {
+    if (!arg) {
+        out += "<?>";
+        return;
+    }
+    char buf[256];
+    int n = 0;
+    switch (arg->type) {
+        case STR:
+            spec += 's';
+            n = snprintf(buf, sizeof(buf), spec.c_str(), std::string(arg->str).c_str());
+            break;
+        case F64:
+            spec += strchr("eEfFgGaA", conv) ? conv : 'g';
+            n = snprintf(buf, sizeof(buf), spec.c_str(), std::bit_cast<double>(arg->word));
+            break;
+        case PTR:
+            spec += 'p';
+            n = snprintf(buf, sizeof(buf), spec.c_str(), reinterpret_cast<void*>(arg->word));
+            break;
+        case I64:
+        case U64:
+            if (conv == 'c') {
+                spec += 'c';
+                n = snprintf(buf, sizeof(buf), spec.c_str(), int(arg->word));
+            } else if (strchr("ouxX", conv)) {
+                spec += "ll";
+                spec += conv;
+                n = snprintf(buf, sizeof(buf), spec.c_str(), (unsigned long long)arg->word);
+            } else if (arg->type == U64) {
+                spec += "llu";
+                n = snprintf(buf, sizeof(buf), spec.c_str(), (unsigned long long)arg->word);
+            } else {
+                spec += "lld";
+                n = snprintf(buf, sizeof(buf), spec.c_str(), (long long)arg->word);
+            }
+            break;
+        case END:
+            break;
+    }
+    if (n > 0) out.append(buf, std::min(size_t(n), sizeof(buf) - 1));
+}
+
+void format_message(std::string& out, const Record& r) {
+    Arg args[MAX_ARGS];
+    const size_t count = decode(r, args);
+    size_t next = 0;
+    auto take = [&]() -> const Arg* { return next < count ? &args[next++] : (++next, nullptr); };
+    auto take_int = [&] {
+        const Arg* a = take();
+        return a && a->type != STR ? std::to_string(int(a->word)) : std::string("0");
+    };
+
+    const char* p = r.fmt;
+    while (*p) {
+        if (*p != '%') {
+            const char* q = strchrnul(p, '%');
+            out.append(p, size_t(q - p));
+            p = q;
+            continue;
+        }
+        if (p[1] == '%') {
+            out += '%';
+            p += 2;
+            continue;
+        }
+        std::string spec = "%";
+        ++p;
+        while (*p && strchr("-+ #0", *p)) spec += *p++;
+        if (*p == '*') {
+            spec += take_int();
+            ++p;
+        }
+        while (*p >= '0' && *p <= '9') spec += *p++;
+        if (*p == '.') {
+            spec += *p++;
+            if (*p == '*') {
+                spec += take_int();
+                ++p;
+            }
+            while (*p >= '0' && *p <= '9') spec += *p++;
+        }
+        while (*p && strchr("hlLqjzt", *p)) ++p;
+        if (!*p) break;
+        const char conv = *p++;
+        format_arg(out, std::move(spec), conv, take());
+    }
+}
+
+// 时间戳换算成墙上时间：HH:MM:SS.uuuuuu，时分秒每秒只算一次
+void format_line(Logger& l, const Record& r, int tid) {
+    const int64_t ns = l.base_ns + int64_t(double(int64_t(r.tsc - l.base_tsc)) / l.tsc_per_ns);
+    const time_t sec = time_t(ns / 1'000'000'000);
+    if (sec != l.last_sec) {
+        tm local;
+        localtime_r(&sec, &local);
+        snprintf(l.hms, sizeof(l.hms), "%02d:%02d:%02d", local.tm_hour, local.tm_min, local.tm_sec);
+        l.last_sec = sec;
+    }
+    char head[48];
+    const int n = snprintf(head, sizeof(head), "%s.%06lld [%d] ", l.hms, (long long)(ns % 1'000'000'000 / 1000), tid);
+    l.out.append(head, size_t(n));
+    format_message(l.out, r);
+    l.out += '\n';
+}
+
+void report_drops(Logger& l, Channel* ch) {
+    const uint64_t d = ch->dropped.load(std::memory_order_relaxed);
+    if (d == ch->reported) return;
+    char line[96];
+    const int n = snprintf(line, sizeof(line), "[alog] thread %d dropped %llu records\n", ch->tid,
+                           (unsigned long long)(d - ch->reported));
+    l.out.append(line, size_t(n));
+    ch->reported = d;
+}
+
+// 取一轮：每个环最多取 DRAIN_BATCH 条，合在一起按时间戳排序后格式化写出，返回取到的条数。
+// 只有后台线程调用；stop 在后台线程退出之后再调一次
+size_t drain(Logger& l) {
+    {
+        std::lock_guard<std::mutex> lock(l.mu);
+        l.scan = l.channels;
+    }
+    l.batch.clear();
+    l.tids.clear();
+    l.dead.clear();
+    for (Channel* ch : l.scan) {
+        // 先看 retired 再取：取完之后这个环不会再有新记录
+        const bool retired = ch->retired.load(std::memory_order_acquire);
+        Record r;
+        size_t taken = 0;
+        while (taken < DRAIN_BATCH && ch->ring.try_pop(r)) {
+            l.batch.push_back(r);
+            l.tids.push_back(ch->tid);
+            ++taken;
+        }
+        ch->popped += taken;
+        report_drops(l, ch);
+        if (retired && ch->ring.empty()) l.dead.push_back(ch);
+    }
+
+    l.order.resize(l.batch.size());
+    for (uint32_t i = 0; i < l.order.size(); ++i) {
+        l.order[i] = i;
+    }
+    std::stable_sort(l.order.begin(), l.order.end(),
+                     [&](uint32_t a, uint32_t b) { return l.batch[a].tsc < l.batch[b].tsc; });
+    for (uint32_t i : l.order) {
+        format_line(l, l.batch[i], l.tids[i]);
+        if (l.out.size() >= FLUSH_BYTES) {
+            write_all(l.options.fd, l.out.data(), l.out.size());
+            l.out.clear();
+        }
+    }
+    if (!l.out.empty()) {
+        write_all(l.options.fd, l.out.data(), l.out.size());
+        l.out.clear();
+    }
+    for (Channel* ch : l.scan) {
+        ch->written.store(ch->popped, std::memory_order_release);
+    }
+
+    if (!l.dead.empty()) {
+        std::lock_guard<std::mutex> lock(l.mu);
+        for (Channel* ch : l.dead) {
+            l.retired_dropped += ch->dropped.load(std::memory_order_relaxed);
+            l.channels.erase(std::find(l.channels.begin(), l.channels.end(), ch));
+            delete ch;
+        }
+    }
+    return l.batch.size();
+}
+
+void run(Logger& l) {
+    l.tsc_per_ns = stats::tsc_per_ns();
+    l.base_tsc = stats::tsc_now();
+    l.base_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch())
+                    .count();
+    while (true) {
+        bool stopping;
+        {
+            std::lock_guard<std::mutex> lock(l.mu);
+            stopping = l.stop_requested;
+        }
+        const size_t n = drain(l);
+        std::unique_lock<std::mutex> lock(l.mu);
+        l.passed.notify_all();
+        // stop 之后 mode 已经是 STOPPED，这一轮取空就不会再有新记录
+        if (stopping && n == 0) break;
+        if (n == 0 && !l.wake_requested && !l.stop_requested) {
+            l.wake.wait_for(lock, IDLE_WAIT, [&] { return l.wake_requested || l.stop_requested; });
+        }
+        l.wake_requested = false;
+    }
+}
+
+constinit thread_local bool tls_exited = false;
+
+// 线程退出时标记自己的 Channel，由后台线程取空后释放。之后别的 thread_local 析构时再写日志不会重新注册
+struct Retire {
+    ~Retire() {
+        if (tls_channel) tls_channel->retired.store(true, std::memory_order_release);
+        tls_channel = nullptr;
+        tls_exited = true;
+    }
+};
+
+}  // namespace
+
+Channel* attach() {
+    Logger& l = logger();
+    if (tls_exited) {
+        std::lock_guard<std::mutex> lock(l.mu);
+        ++l.retired_dropped;
+        return nullptr;
+    }
+    thread_local Retire retire;
+    auto* ch = new Channel;
+    ch->tid = int(syscall(SYS_gettid));
+    {
+        std::lock_guard<std::mutex> lock(l.mu);
+        ch->serial = l.next_serial++;
+        l.channels.push_back(ch);
+    }
+    return tls_channel = ch;
+}
+
+bool wait_for_space(Channel* ch) {
+    Logger& l = logger();
+    for (unsigned spin = 0; ch->ring.full(); ++spin) {
+        if (mode.load(std::memory_order_relaxed) != BLOCK) return false;
+        if (spin == 0) {
+            std::lock_guard<std::mutex> lock(l.mu);
+            l.wake_requested = true;
+            l.wake.notify_one();
+        }
+        if (spin < 64) {
+            _mm_pause();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    return true;
+}
+
+}  // namespace detail
+
+void start(const Options& options) {
+    detail::Logger& l = detail::logger();
+    std::unique_lock<std::mutex> lock(l.mu);
+    l.passed.wait(lock, [&] { return !l.stopping; });
+    if (l.running) return;
+    static const bool at_exit = std::atexit(stop) == 0;
+    (void)at_exit;
+    l.options = options;
+    l.stop_requested = false;
+    l.running = true;
+    l.thread = std::thread(detail::run, std::ref(l));
+    detail::mode.store(options.overflow == Overflow::Block ? detail::BLOCK : detail::DROP, std::memory_order_relaxed);
+}
+
+void stop() {
+    detail::Logger& l = detail::logger();
+    std::thread thread;
+    {
+        std::unique_lock<std::mutex> lock(l.mu);
+        // 同时有别的 stop（比如 atexit 里的）时只有一个去 join，其余的等它把记录写完
+        l.passed.wait(lock, [&] { return !l.stopping; });
+        if (!l.running) return;
+        l.stopping = true;
+        thread = std::move(l.thread);
+        detail::mode.store(detail::STOPPED, std::memory_order_relaxed);
+        l.stop_requested = true;
+        l.wake.notify_one();
+    }
+    thread.join();
+    // 看到 mode 还没变的写者可能在后台线程最后一轮之后才进环，现在只剩这里在取，再取一遍
+    while (detail::drain(l) > 0) {
+    }
+    std::lock_guard<std::mutex> lock(l.mu);
+    l.running = false;
+    l.stopping = false;
+    l.passed.notify_all();
+}
+
+void flush() {
+    detail::Logger& l = detail::logger();
+    std::unique_lock<std::mutex> lock(l.mu);
+    if (!l.running) return;
+    // 记下每个环此刻进了多少条，等这些都写出去；之后一直有线程在写日志也不影响。
+    // 不在表里的 Channel 已经取空释放了
+    struct Target {
+        detail::Channel* ch;
+        uint64_t serial;
+        uint64_t pushed;
+    };
+    std::vector<Target> targets;
+    for (detail::Channel* ch : l.channels) {
+        targets.push_back({ch, ch->serial, ch->pushed.load(std::memory_order_acquire)});
+    }
+    l.wake_requested = true;
+    l.wake.notify_one();
+    l.passed.wait(lock, [&] {
+        if (!l.running) return true;
+        std::erase_if(targets, [&](const Target& t) {
+            auto it = std::find(l.channels.begin(), l.channels.end(), t.ch);
+            return it == l.channels.end() || (*it)->serial != t.serial ||
+                   t.ch->written.load(std::memory_order_acquire) >= t.pushed;
+        });
+        return targets.empty();
+    });
+}
+
+uint64_t dropped() {
+    detail::Logger& l = detail::logger();
+    std::lock_guard<std::mutex> lock(l.mu);
+    uint64_t total = l.retired_dropped;
+    for (detail::Channel* ch : l.channels) {
+        total += ch->dropped.load(std::memory_order_relaxed);
+        // 停下之后还留在环里的（stop 最后那遍之后才进环的）写不出去了，除非再 start。
+        // pushed 在进环之后才加，可能比 written 小
+        if (!l.running) {
+            const uint64_t pushed = ch->pushed.load(std::memory_order_relaxed);
+            const uint64_t written = ch->written.load(std::memory_order_relaxed);
+            if (pushed > written) total += pushed - written;
+        }
+    }
+    return total;
+}
+
+}  // namespace alog
@@ -0,0 +1,97 @@
+#ifndef __CO_ASYNC__
+#define __CO_ASYNC__
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+#include "SmallAlloc.h"
+#include "Trace.h"
+
+// 可被 co_await 的惰性协程：创建时不运行，被等待时才启动，结束后对称转移回等待者。
+// 与 Task 不同，它有返回值和 continuation，用来写需要循环挂起的多步异步操作
+namespace detail {
+
+struct AsyncPromiseBase {
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+
+    // 和 Task 一样，帧走小对象分配器
+    static void* operator new(size_t size) { return alloc::allocate(size); }
+    static void operator delete(void* p, size_t size) noexcept {
+        co_trace::frame_destroyed(p);
+        alloc::deallocate(p, size);
+    }
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        template<typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+            return h.promise().continuation;
+        }
+        void await_resume() noexcept {}
+    };
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { std::terminate(); }
+};
+
+}  // namespace detail
+
+template<typename T>
+class Async {
+public:
+    struct promise_type : detail::AsyncPromiseBase {
+        std::optional<T> value;
+
+        Async get_return_object() { return Async{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        void return_value(T v) { value.emplace(std::move(v)); }
+    };
+
+    explicit Async(std::coroutine_handle<promise_type> h_) : h(h_) {}
+    Async(Async&& other) noexcept : h(std::exchange(other.h, nullptr)) {}
+    Async& operator=(Async&&) = delete;
+    ~Async() { if (h) h.destroy(); }
+
+    bool await_ready() { return false; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> c) {
+        h.promise().continuation = c;
+        return h;
+    }
+
+    T await_resume() { return std::move(*h.promise().value); }
+
+private:
+    std::coroutine_handle<promise_type> h;
+};
+
+// 先同步尝试（数据已经在缓冲区里时不分配协程帧、不挂起），失败才启动慢路径 Async 协程。
+// try_fn: bool(T& out)，返回 true 表示已经得到结果；slow_fn: () -> Async<T>
+template<typename T, typename TryFn, typename SlowFn>
+class FastPathAwaiter {
+public:
+    FastPathAwaiter(TryFn try_fn, SlowFn slow_fn) : try_fn_(std::move(try_fn)), slow_fn_(std::move(slow_fn)) {}
+
+    bool await_ready() { return try_fn_(result_); }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> h) {
+        slow_.emplace(slow_fn_());
+        return slow_->await_suspend(h);
+    }
+
+    T await_resume() { return slow_ ? slow_->await_resume() : std::move(result_); }
+
+private:
+    TryFn try_fn_;
+    SlowFn slow_fn_;
+    T result_{};
+    std::optional<Async<T>> slow_;
+};
+
+template<typename T, typename TryFn, typename SlowFn>
+FastPathAwaiter<T, TryFn, SlowFn> fast_path(TryFn try_fn, SlowFn slow_fn) {
+    return {std::move(try_fn), std::move(slow_fn)};
+}
+
+#endif /* __CO_ASYNC__ */
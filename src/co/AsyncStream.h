@@ -0,0 +1,376 @@
+#ifndef __CO_ASYNCSTREAM__
+#define __CO_ASYNCSTREAM__
+#include <sys/epoll.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "Async.h"
+#include "BufferPool.h"
+#include "Reactor.h"
+
+// 基于 Reactor 的带缓冲连接流。
+//
+// 读：数据读进一块可增长的池化缓冲区，read_until / read_exact 直接返回指向缓冲区的
+//     string_view，不拷贝。视图在下一次需要从 socket 补数据之前一直有效，因此缓冲区里
+//     已有的多个（流水线）请求可以连续取出、各自引用。
+// 写：write 只把 iovec 排进队列（零拷贝，数据须存活到 flush 完成），write_copy 拷贝进流
+//     自带的写缓冲区。flush 用一次 writev 发出整个队列；读操作在补数据之前会先 flush，
+//     所以处理完一批流水线请求后只有一次写系统调用。
+class AsyncStream {
+public:
+    using ReadResult = std::optional<std::string_view>;  // nullopt 表示 EOF / 出错 / 帧超长
+
+    static constexpr size_t INITIAL_BUFFER = 4096;
+    static constexpr size_t MAX_BUFFER = 64 << 20;
+    static constexpr size_t WRITE_CHUNK = 4096;
+
+    AsyncStream(Reactor& reactor, int fd) : reactor_(reactor), fd_(fd), rbuf_(INITIAL_BUFFER) {}
+    ~AsyncStream() { close(); }
+
+    AsyncStream(const AsyncStream&) = delete;
+    AsyncStream& operator=(const AsyncStream&) = delete;
+
+    int fd() const noexcept { return fd_; }
+    bool eof() const noexcept { return eof_; }
+    bool error() const noexcept { return error_; }
+
+    // ────────────────────────────────────────────────
+    //  读
+    // ────────────────────────────────────────────────
+
+    // 返回以 delim 结尾（含 delim）的一段；max 限制单帧长度
+    auto read_until(char delim, size_t max = MAX_BUFFER) {
+        return fast_path<ReadResult>([this, delim, max](ReadResult& out) { return try_read_until(delim, max, out); },
+                                     [this, delim, max] { return read_slow(delim, max, 0); });
+    }
+
+    // 返回恰好 n 个字节
+    auto read_exact(size_t n) {
+        return fast_path<ReadResult>([this, n](ReadResult& out) { return try_read_exact(n, out); },
+                                     [this, n] { return read_slow(0, 0, n); });
+    }
+
+    // 只在缓冲区里找，不做 IO；返回 true 表示 out 已确定（拿到数据或流已结束）
+    bool try_read_until(char delim, size_t max, ReadResult& out) {
+        if (delim != scan_delim_) {  // 换了分隔符，之前扫过的部分里可能有新的分隔符
+            scan_ = rpos_;
+            scan_delim_ = delim;
+        }
+        char* begin = rbuf_.data() + std::max(rpos_, scan_);
+        char* end = rbuf_.data() + rend_;
+        if (auto* p = static_cast<char*>(std::memchr(begin, delim, end - begin))) {
+            out = consume(p + 1 - (rbuf_.data() + rpos_));
+            return true;
+        }
+        scan_ = rend_;  // 下次从这里接着找，避免重复扫描
+        if (rend_ - rpos_ >= max) error_ = true;
+        return finished(out);
+    }
+
+    bool try_read_exact(size_t n, ReadResult& out) {
+        if (rend_ - rpos_ >= n) {
+            out = consume(n);
+            return true;
+        }
+        if (n > MAX_BUFFER) error_ = true;
+        return finished(out);
+    }
+
+    // ────────────────────────────────────────────────
+    //  写
+    // ────────────────────────────────────────────────
+
+    // 零拷贝排队：data 必须存活到 flush 完成（本流读出的视图满足这一点）
+    void write(std::string_view data) {
+        if (data.empty()) return;
+        push_iov(data.data(), data.size());
+    }
+
+    // 拷贝进流自己的写缓冲区，适合临时构造的小块（如长度前缀）
+    void write_copy(std::string_view data) {
+        if (data.empty()) return;
+        if (wstore_.empty() || wstore_.back().capacity() - wstore_used_ < data.size()) {
+            wstore_.emplace_back(std::max(WRITE_CHUNK, data.size()));
+            wstore_used_ = 0;
+        }
+        char* dst = wstore_.back().data() + wstore_used_;
+        std::memcpy(dst, data.data(), data.size());
+        wstore_used_ += data.size();
+        push_iov(dst, data.size());
+    }
+
+    size_t pending_writes() const noexcept { return wq_.size() - wq_head_; }
+
+    // 发出所有排队的数据，返回 false 表示连接出错
+    auto flush() {
+        return fast_path<bool>(
+            [this](bool& ok) {
+                ok = flush_now();
+                return ok || error_;
+            },
+            [this] { return flush_slow(); });
+    }
+
+    void close() {
+        if (fd_ < 0) return;
+        reactor_.remove_fd(fd_);
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+private:
+    bool finished(ReadResult& out) {
+        if (!eof_ && !error_) return false;
+        out.reset();
+        return true;
+    }
+
+    std::string_view consume(size_t n) {
+        std::string_view v(rbuf_.data() + rpos_, n);
+        rpos_ += n;
+        return v;
+    }
+
+    // exact == 0 时按 delim 读，否则读 exact 个字节
+    Async<ReadResult> read_slow(char delim, size_t max, size_t exact) {
+        while (true) {
+            ReadResult out;
+            if (exact == 0 ? try_read_until(delim, max, out) : try_read_exact(exact, out)) co_return out;
+
+            // 补数据会搬动缓冲区，先把可能引用它的排队写发出去
+            if (pending_writes() > 0 && !co_await flush()) co_return std::nullopt;
+
+            make_room(exact);
+            if (fill() > 0 || eof_ || error_) continue;
+            co_await reactor_.await_event(fd_, EPOLLIN);
+        }
+    }
+
+    // 把未取走的数据挪到缓冲区开头，空间仍不够就换一块更大的
+    void make_room(size_t need) {
+        size_t unread = rend_ - rpos_;
+        size_t cap = rbuf_.capacity();
+        size_t want = std::max(need, unread + 1);
+        if (want > cap || (rend_ == cap && rpos_ == 0)) {
+            size_t new_cap = std::max(cap * 2, want);
+            if (new_cap > MAX_BUFFER) {
+                error_ = true;
+                return;
+            }
+            PooledBuffer bigger(new_cap);
+            std::memcpy(bigger.data(), rbuf_.data() + rpos_, unread);
+            rbuf_ = std::move(bigger);
+        } else if (rpos_ > 0) {
+            std::memmove(rbuf_.data(), rbuf_.data() + rpos_, unread);
+        } else {
+            return;
+        }
+        scan_ = scan_ > rpos_ ? scan_ - rpos_ : 0;
+        rpos_ = 0;
+        rend_ = unread;
+    }
+
+    // 边缘触发：一直读到 EAGAIN 或缓冲区满，返回读到的字节数
+    size_t fill() {
+        size_t total = 0;
+        while (rend_ < rbuf_.capacity()) {
+            ssize_t r = ::read(fd_, rbuf_.data() + rend_, rbuf_.capacity() - rend_);
+            if (r > 0) {
+                rend_ += r;
+                total += r;
+            } else if (r == 0) {
+                eof_ = true;
+                break;
+            } else if (errno == EINTR) {
+                continue;
+            } else {
+                if (errno != EAGAIN && errno != EWOULDBLOCK) error_ = true;
+                break;
+            }
+        }
+        return total;
+    }
+
+    void push_iov(const char* p, size_t n) {
+        // 与上一段首尾相接（连续的 write_copy）就合并，减少 iovec 数量
+        if (wq_.size() > wq_head_) {
+            iovec& last = wq_.back();
+            if (static_cast<char*>(last.iov_base) + last.iov_len == p) {
+                last.iov_len += n;
+                return;
+            }
+        }
+        wq_.push_back({const_cast<char*>(p), n});
+    }
+
+    // 一直 writev 到队列清空或 EAGAIN；返回 true 表示全部写完
+    bool flush_now() {
+        while (wq_head_ < wq_.size()) {
+            int cnt = static_cast<int>(std::min<size_t>(wq_.size() - wq_head_, IOV_MAX));
+            ssize_t w = ::writev(fd_, &wq_[wq_head_], cnt);
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) return false;
+                error_ = true;
+                reset_writes();
+                return false;
+            }
+            size_t left = w;
+            while (left > 0) {
+                iovec& v = wq_[wq_head_];
+                if (left >= v.iov_len) {
+                    left -= v.iov_len;
+                    ++wq_head_;
+                } else {
+                    v.iov_base = static_cast<char*>(v.iov_base) + left;
+                    v.iov_len -= left;
+                    left = 0;
+                }
+            }
+        }
+        reset_writes();
+        return true;
+    }
+
+    Async<bool> flush_slow() {
+        while (true) {
+            co_await reactor_.await_event(fd_, EPOLLOUT);
+            if (flush_now()) co_return true;
+            if (error_) co_return false;
+        }
+    }
+
+    void reset_writes() {
+        wq_.clear();
+        wq_head_ = 0;
+        if (wstore_.size() > 1) wstore_.resize(1);
+        wstore_used_ = 0;
+    }
+
+    Reactor& reactor_;
+    int fd_;
+    bool eof_ = false;
+    bool error_ = false;
+
+    PooledBuffer rbuf_;
+    size_t rpos_ = 0;  // 第一个未取走的字节
+    size_t rend_ = 0;  // 有效数据末尾
+    size_t scan_ = 0;  // read_until 已扫描到的位置
+    char scan_delim_ = '\0';  // scan_ 是按哪个分隔符扫的
+
+    std::vector<iovec> wq_;
+    size_t wq_head_ = 0;
+    std::vector<PooledBuffer> wstore_;
+    size_t wstore_used_ = 0;
+};
+
+// ────────────────────────────────────────────────
+//  分帧：按行 / 按 4 字节大端长度前缀
+// ────────────────────────────────────────────────
+
+// 每帧一行，返回的视图去掉了 "\n" 或 "\r\n"
+class LineFramer {
+public:
+    explicit LineFramer(AsyncStream& stream, size_t max_line = 64 << 10) : stream_(stream), max_line_(max_line) {}
+
+    auto next() {
+        return fast_path<AsyncStream::ReadResult>([this](AsyncStream::ReadResult& out) { return try_next(out); },
+                                                  [this] { return next_slow(); });
+    }
+
+    // 只取缓冲区里已有的完整行，不做 IO；返回 true 表示 out 已确定（拿到一行或流已结束）
+    bool try_next(AsyncStream::ReadResult& out) {
+        if (!stream_.try_read_until('\n', max_line_, out)) return false;
+        out = strip(out);
+        return true;
+    }
+
+    void send(std::string_view line) {
+        stream_.write(line);
+        stream_.write("\n");
+    }
+
+private:
+    static AsyncStream::ReadResult strip(AsyncStream::ReadResult line) {
+        if (!line) return line;
+        line->remove_suffix(1);
+        if (!line->empty() && line->back() == '\r') line->remove_suffix(1);
+        return line;
+    }
+
+    Async<AsyncStream::ReadResult> next_slow() { co_return strip(co_await stream_.read_until('\n', max_line_)); }
+
+    AsyncStream& stream_;
+    size_t max_line_;
+};
+
+// 每帧 = 4 字节大端长度 + 负载，返回的视图只含负载
+class LengthPrefixedFramer {
+public:
+    static constexpr size_t HEADER = 4;
+
+    explicit LengthPrefixedFramer(AsyncStream& stream, size_t max_frame = 16 << 20)
+        : stream_(stream), max_frame_(max_frame) {}
+
+    auto next() {
+        return fast_path<AsyncStream::ReadResult>(
+            [this](AsyncStream::ReadResult& out) {
+                // 头和负载都已在缓冲区里才走快路径，避免只取走半帧
+                AsyncStream::ReadResult hdr;
+                if (!stream_.try_read_exact(HEADER, hdr)) return false;
+                if (!hdr) {
+                    out.reset();
+                    return true;
+                }
+                size_t len = decode(*hdr);
+                if (len > max_frame_) {
+                    out.reset();
+                    return true;
+                }
+                if (stream_.try_read_exact(len, out)) return true;
+                pending_len_ = len;
+                return false;
+            },
+            [this] { return next_slow(); });
+    }
+
+    void send(std::string_view payload) {
+        uint32_t len = static_cast<uint32_t>(payload.size());
+        char hdr[HEADER] = {char(len >> 24), char(len >> 16), char(len >> 8), char(len)};
+        stream_.write_copy({hdr, HEADER});
+        stream_.write(payload);
+    }
+
+private:
+    static size_t decode(std::string_view hdr) {
+        auto b = reinterpret_cast<const unsigned char*>(hdr.data());
+        return (size_t(b[0]) << 24) | (size_t(b[1]) << 16) | (size_t(b[2]) << 8) | size_t(b[3]);
+    }
+
+    Async<AsyncStream::ReadResult> next_slow() {
+        size_t len = pending_len_;
+        pending_len_ = SIZE_MAX;
+        if (len == SIZE_MAX) {
+            auto hdr = co_await stream_.read_exact(HEADER);
+            if (!hdr) co_return std::nullopt;
+            len = decode(*hdr);
+            if (len > max_frame_) co_return std::nullopt;
+        }
+        co_return co_await stream_.read_exact(len);
+    }
+
+    AsyncStream& stream_;
+    size_t max_frame_;
+    size_t pending_len_ = SIZE_MAX;  // 快路径已取走头部、还差负载时记下长度
+};
+
+#endif /* __CO_ASYNCSTREAM__ */
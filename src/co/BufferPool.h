@@ -0,0 +1,104 @@
+#ifndef __CO_BUFFERPOOL__
+#define __CO_BUFFERPOOL__
+#include <bit>
+#include <cstddef>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+// 线程本地的 2 的幂尺寸缓冲区池。连接的读写缓冲区在 reactor 线程上申请和归还，
+// 不需要任何同步；超过 MAX_POOLED 的大块直接走 malloc
+class BufferPool {
+public:
+    static constexpr size_t MIN_SIZE = 4096;
+    static constexpr size_t MAX_POOLED = 1 << 20;
+    static constexpr size_t MAX_CACHED_PER_CLASS = 64;
+
+    // capacity 向上取整为 2 的幂
+    static char* acquire(size_t& capacity) {
+        capacity = round_up(capacity);
+        if (capacity <= MAX_POOLED) {
+            auto& list = free_lists()[class_index(capacity)];
+            if (!list.empty()) {
+                char* p = list.back();
+                list.pop_back();
+                return p;
+            }
+        }
+        return static_cast<char*>(std::aligned_alloc(64, capacity));
+    }
+
+    static void release(char* p, size_t capacity) {
+        if (capacity <= MAX_POOLED) {
+            auto& list = free_lists()[class_index(capacity)];
+            if (list.size() < MAX_CACHED_PER_CLASS) {
+                list.push_back(p);
+                return;
+            }
+        }
+        std::free(p);
+    }
+
+    static size_t round_up(size_t n) { return n <= MIN_SIZE ? MIN_SIZE : std::bit_ceil(n); }
+
+private:
+    static constexpr size_t CLASS_COUNT = std::countr_zero(MAX_POOLED) - std::countr_zero(MIN_SIZE) + 1;
+
+    static size_t class_index(size_t capacity) { return std::countr_zero(capacity) - std::countr_zero(MIN_SIZE); }
+
+    struct FreeLists {
+        std::vector<char*> lists[CLASS_COUNT];
+
+        ~FreeLists() {
+            for (auto& list : lists) {
+                for (char* p : list) {
+                    std::free(p);
+                }
+            }
+        }
+
+        std::vector<char*>& operator[](size_t i) { return lists[i]; }
+    };
+
+    static FreeLists& free_lists() {
+        static thread_local FreeLists lists;
+        return lists;
+    }
+};
+
+// 从 BufferPool 借出的一块缓冲区，析构时归还
+class PooledBuffer {
+public:
+    PooledBuffer() = default;
+    explicit PooledBuffer(size_t capacity) : cap_(capacity) { data_ = BufferPool::acquire(cap_); }
+    ~PooledBuffer() { reset(); }
+
+    PooledBuffer(PooledBuffer&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), cap_(std::exchange(other.cap_, 0)) {}
+    PooledBuffer& operator=(PooledBuffer&& other) noexcept {
+        if (this != &other) {
+            reset();
+            data_ = std::exchange(other.data_, nullptr);
+            cap_ = std::exchange(other.cap_, 0);
+        }
+        return *this;
+    }
+
+    PooledBuffer(const PooledBuffer&) = delete;
+    PooledBuffer& operator=(const PooledBuffer&) = delete;
+
+    void reset() {
+        if (data_) BufferPool::release(data_, cap_);
+        data_ = nullptr;
+        cap_ = 0;
+    }
+
+    char* data() const noexcept { return data_; }
+    size_t capacity() const noexcept { return cap_; }
+
+private:
+    char* data_ = nullptr;
+    size_t cap_ = 0;
+};
+
+#endif /* __CO_BUFFERPOOL__ */
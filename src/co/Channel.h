@@ -0,0 +1,311 @@
+#ifndef __CO_CHANNEL__
+#define __CO_CHANNEL__
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <source_location>
+#include <utility>
+#include <vector>
+
+#include "MpmcRingBuffer.h"
+#include "Reactor.h"
+#include "SpscRingBuffer.h"
+
+// 协程 / 线程之间的异步通道，底层是无锁环形队列。
+//
+// 快路径只有一次 ring 操作加一次等待者计数的读取；环空（或满）时协程挂起，
+// 由对端在 push（或 pop）之后把数据直接交付给等待者，再通过 Reactor::post 唤醒，
+// 全程不自旋。普通线程一侧使用 *_blocking 接口，在 std::atomic::wait 上睡眠。
+template<typename T, typename Ring>
+class Channel {
+    // 挂起中的一方。recv 等待者：slot 由生产者填入；send 等待者：slot 是待发送的值
+    struct Waiter {
+        Waiter* next = nullptr;
+        std::optional<T> slot;
+        Reactor* reactor = nullptr;  // nullptr 表示普通线程在等
+        std::coroutine_handle<> h;
+        std::atomic<bool> done{false};
+
+        // 总是在对端 WaitList 的锁里调用，见 wait_blocking
+        void wake() {
+            if (reactor) {
+                reactor->post(h);
+            } else {
+                done.store(true, std::memory_order_release);
+                done.notify_one();
+            }
+        }
+    };
+
+    // 等待者 FIFO，只在慢路径上加锁；count 给对端的快路径判断“有没有人在等”
+    struct WaitList {
+        std::mutex mu;
+        Waiter* head = nullptr;
+        Waiter* tail = nullptr;
+        alignas(64) std::atomic<size_t> count{0};
+
+        void push_back(Waiter* w) {
+            w->next = nullptr;
+            if (tail) {
+                tail->next = w;
+            } else {
+                head = w;
+            }
+            tail = w;
+        }
+
+        Waiter* pop_front() {
+            Waiter* w = head;
+            head = w->next;
+            if (!head) tail = nullptr;
+            count.fetch_sub(1, std::memory_order_relaxed);
+            return w;
+        }
+    };
+
+public:
+    Channel() = default;
+    ~Channel() = default;
+
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+
+    // ────────────────────────────────────────────────
+    //  协程接口
+    // ────────────────────────────────────────────────
+
+    // 等待者嵌在 awaiter 里，随协程帧一起存活，挂起期间无需额外分配
+    struct SendAwaiter {
+        Channel& ch;
+        std::source_location loc;
+        Waiter w;
+
+        SendAwaiter(Channel& c, T value, std::source_location l) : ch(c), loc(l) { w.slot.emplace(std::move(value)); }
+
+        bool await_ready() {
+            if (!ch.ring_.try_emplace(std::move(*w.slot))) return false;
+            ch.on_pushed();
+            return true;
+        }
+
+        bool await_suspend(std::coroutine_handle<> h) {
+            w.reactor = Reactor::current();
+            w.h = h;
+            if (!ch.park_sender(&w)) return false;
+            if (w.reactor) w.reactor->trace_suspend(h, loc);
+            return true;
+        }
+
+        void await_resume() {}
+    };
+
+    struct RecvAwaiter {
+        Channel& ch;
+        std::source_location loc;
+        Waiter w;
+
+        RecvAwaiter(Channel& c, std::source_location l) : ch(c), loc(l) {}
+
+        bool await_ready() {
+            T out;
+            if (!ch.ring_.try_pop(out)) return false;
+            w.slot.emplace(std::move(out));
+            ch.on_popped();
+            return true;
+        }
+
+        bool await_suspend(std::coroutine_handle<> h) {
+            w.reactor = Reactor::current();
+            w.h = h;
+            if (!ch.park_receiver(&w)) return false;
+            if (w.reactor) w.reactor->trace_suspend(h, loc);
+            return true;
+        }
+
+        T await_resume() { return std::move(*w.slot); }
+    };
+
+    // 一次恢复取走当前所有可读数据（至少 1 个，至多 max 个），返回本次追加到 out 的数量
+    struct RecvBatchAwaiter {
+        Channel& ch;
+        std::vector<T>& out;
+        size_t max;
+        std::source_location loc;
+        size_t n = 0;
+        Waiter w;
+
+        RecvBatchAwaiter(Channel& c, std::vector<T>& o, size_t m, std::source_location l)
+            : ch(c), out(o), max(m == 0 ? 1 : m), loc(l) {}
+
+        bool await_ready() {
+            n = ch.drain(out, max);
+            return n > 0;
+        }
+
+        bool await_suspend(std::coroutine_handle<> h) {
+            w.reactor = Reactor::current();
+            w.h = h;
+            if (!ch.park_receiver(&w)) return false;
+            if (w.reactor) w.reactor->trace_suspend(h, loc);
+            return true;
+        }
+
+        size_t await_resume() {
+            if (n > 0) return n;  // await_ready 已经取到数据
+            out.push_back(std::move(*w.slot));
+            return 1 + ch.drain(out, max - 1);
+        }
+    };
+
+    // loc 只在 CO_TRACE 打开时用于按 co_await 位置统计挂起时间
+    SendAwaiter send(T value, std::source_location loc = std::source_location::current()) {
+        return SendAwaiter{*this, std::move(value), loc};
+    }
+
+    RecvAwaiter recv(std::source_location loc = std::source_location::current()) { return RecvAwaiter{*this, loc}; }
+
+    RecvBatchAwaiter recv_batch(std::vector<T>& out, size_t max = SIZE_MAX,
+                                std::source_location loc = std::source_location::current()) {
+        return RecvBatchAwaiter{*this, out, max, loc};
+    }
+
+    // ────────────────────────────────────────────────
+    //  线程接口（非协程调用方）
+    // ────────────────────────────────────────────────
+
+    bool try_send(T value) {
+        if (!ring_.try_emplace(std::move(value))) return false;
+        on_pushed();
+        return true;
+    }
+
+    bool try_recv(T& out) {
+        if (!ring_.try_pop(out)) return false;
+        on_popped();
+        return true;
+    }
+
+    // 环满时在 atomic::wait 上睡眠，直到消费者把值搬进环里
+    void send_blocking(T value) {
+        if (try_send(std::move(value))) return;
+        Waiter w;
+        w.slot.emplace(std::move(value));
+        if (park_sender(&w)) wait_blocking(send_waiters_, w);
+    }
+
+    T recv_blocking() {
+        T out;
+        if (try_recv(out)) return out;
+        Waiter w;
+        if (park_receiver(&w)) wait_blocking(recv_waiters_, w);
+        return std::move(*w.slot);
+    }
+
+    bool empty() const noexcept { return ring_.empty(); }
+    size_t size() const noexcept { return ring_.size(); }
+
+private:
+    // done 变成 true 时唤醒方可能还没执行完 notify_one，这时 w 还不能随栈帧销毁。
+    // 唤醒方从摘下 w 到 notify_one 返回一直拿着 list.mu，这里拿一次锁就等到了它放手
+    static void wait_blocking(WaitList& list, Waiter& w) {
+        w.done.wait(false, std::memory_order_acquire);
+        std::lock_guard<std::mutex> lock(list.mu);
+    }
+
+    // 加锁后再检查一次 ring，避免与对端的快路径之间丢失唤醒。
+    // 返回 true 表示已挂入等待队列，需要挂起
+    bool park_receiver(Waiter* w) {
+        {
+            std::lock_guard<std::mutex> lock(recv_waiters_.mu);
+            recv_waiters_.count.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            T out;
+            if (!ring_.try_pop(out)) {
+                recv_waiters_.push_back(w);
+                return true;
+            }
+            recv_waiters_.count.fetch_sub(1, std::memory_order_relaxed);
+            w->slot.emplace(std::move(out));
+        }
+        on_popped();
+        return false;
+    }
+
+    bool park_sender(Waiter* w) {
+        {
+            std::lock_guard<std::mutex> lock(send_waiters_.mu);
+            send_waiters_.count.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!ring_.try_emplace(std::move(*w->slot))) {
+                send_waiters_.push_back(w);
+                return true;
+            }
+            send_waiters_.count.fetch_sub(1, std::memory_order_relaxed);
+        }
+        on_pushed();
+        return false;
+    }
+
+    // push 之后：如果有接收者在等，从环里取数据直接交给它们。
+    // 此时被交付的接收者都处于挂起状态，所以对 SPSC 环来说仍然只有一个“消费者”在 pop
+    void on_pushed() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (recv_waiters_.count.load(std::memory_order_relaxed) == 0) return;
+
+        bool popped = false;
+        {
+            std::lock_guard<std::mutex> lock(recv_waiters_.mu);
+            T out;
+            while (recv_waiters_.head && ring_.try_pop(out)) {
+                Waiter* w = recv_waiters_.pop_front();
+                w->slot.emplace(std::move(out));
+                w->wake();  // 之后不能再访问 w
+                popped = true;
+            }
+        }
+        if (popped) on_popped();
+    }
+
+    // pop 之后：如果有发送者在等，把它们的值搬进环里
+    void on_popped() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (send_waiters_.count.load(std::memory_order_relaxed) == 0) return;
+
+        bool pushed = false;
+        {
+            std::lock_guard<std::mutex> lock(send_waiters_.mu);
+            while (send_waiters_.head && ring_.try_emplace(std::move(*send_waiters_.head->slot))) {
+                Waiter* w = send_waiters_.pop_front();
+                w->wake();
+                pushed = true;
+            }
+        }
+        if (pushed) on_pushed();
+    }
+
+    size_t drain(std::vector<T>& out, size_t max) {
+        size_t n = 0;
+        T v;
+        while (n < max && ring_.try_pop(v)) {
+            out.push_back(std::move(v));
+            ++n;
+        }
+        if (n > 0) on_popped();
+        return n;
+    }
+
+    Ring ring_;
+    WaitList recv_waiters_;
+    WaitList send_waiters_;
+};
+
+template<typename T, size_t Capacity>
+using SpscChannel = Channel<T, SpscRingBuffer<T, Capacity>>;
+
+template<typename T, size_t Capacity>
+using MpmcChannel = Channel<T, MpmcRingBuffer<T, Capacity>>;
+
+#endif /* __CO_CHANNEL__ */
@@ -0,0 +1,376 @@
+#ifndef __CO_REACTOR__
+#define __CO_REACTOR__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <source_location>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include "MpmcRingBuffer.h"
+#include "SmallAlloc.h"
+#include "Trace.h"
+
+struct Task {
+    struct promise_type {
+        bool detached = false;
+
+        // 协程帧走小对象分配器，超过 2K 的帧仍由 operator new 分配
+        static void* operator new(size_t size) { return alloc::allocate(size); }
+        static void operator delete(void* p, size_t size) noexcept {
+            co_trace::frame_destroyed(p);
+            alloc::deallocate(p, size);
+        }
+
+        // detach 之后结束时不再挂起，协程帧自行销毁
+        struct FinalAwaiter {
+            bool detached;
+            bool await_ready() noexcept { return detached; }
+            void await_suspend(std::coroutine_handle<>) noexcept {}
+            void await_resume() noexcept {}
+        };
+
+        Task get_return_object() { return Task{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        std::suspend_never initial_suspend() { return {}; }
+        FinalAwaiter final_suspend() noexcept { return {detached}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+    std::coroutine_handle<promise_type> h;
+    explicit Task(std::coroutine_handle<promise_type> h_) : h(h_) {}
+    ~Task() { if (h) h.destroy(); }
+    Task(Task&& other) noexcept : h(std::exchange(other.h, nullptr)) {}
+    Task& operator=(Task&&) = delete;
+    void resume() { if (h && !h.done()) h.resume(); }
+    bool done() const { return !h || h.done(); }
+
+    // 放弃所有权，协程运行结束后自行释放（用于每连接一个的协程）
+    void detach() {
+        if (!h) return;
+        if (h.done()) {
+            h.destroy();
+        } else {
+            h.promise().detached = true;
+        }
+        h = nullptr;
+    }
+};
+
+class Reactor {
+public:
+    Reactor() {
+        epfd = epoll_create1(0);
+        if (epfd == -1) throw std::runtime_error("epoll_create1 failed");
+
+        // 跨线程唤醒用的 eventfd，常驻 epoll 集合（水平触发）
+        wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wake_fd == -1) throw std::runtime_error("eventfd failed");
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = wake_fd;
+        if (epoll_ctl(epfd, EPOLL_CTL_ADD, wake_fd, &ev) == -1) throw std::runtime_error("epoll_ctl add failed");
+
+        if (current_reactor == nullptr) make_current(this);
+#if CO_TRACE
+        co_trace::register_loop(&trace);
+#endif
+    }
+
+    ~Reactor() {
+#if CO_TRACE
+        co_trace::unregister_loop(&trace);
+#endif
+        if (current_reactor == this) make_current(nullptr);
+        close(wake_fd);
+        close(epfd);
+    }
+
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+
+    // 当前线程正在驱动（或最先创建）的 reactor，供 Channel 等组件找到挂起协程所属的 reactor
+    static Reactor* current() noexcept { return current_reactor; }
+
+    void run() {
+        Reactor* prev = current_reactor;
+        make_current(this);
+        while (!stopped.load(std::memory_order_acquire)) {
+#if CO_TRACE
+            const uint64_t loop_start = co_trace::now_ns();
+#endif
+            // 每轮最多搬运 INJECT_BATCH 个跨线程投递的协程，避免饿死 IO
+            bool more_injected = drain_injected();
+
+            // 处理就绪协程队列
+            while (!ready_queue.empty()) {
+                auto entry = ready_queue.front();
+                ready_queue.pop_front();
+                resume(entry);
+            }
+
+            epoll_event events[128];
+            int n = wait_events(events, 128, more_injected ? 0 : -1);
+            if (n == -1) {
+                if (errno == EINTR) continue;
+                break;
+            }
+
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                // uint32_t ev = events[i].events; // 可以根据 ev 处理错误等
+
+                if (fd == wake_fd) {
+                    consume_wakeup();
+                    continue;
+                }
+
+                auto it = waiting_coros.find(fd);
+                if (it != waiting_coros.end()) {
+                    ready_queue.push_back(it->second);
+                    // 一次性等待：协程可能在别的挂起点（甚至已销毁），需要时会再次 co_await 设置
+                    waiting_coros.erase(it);
+                }
+            }
+#if CO_TRACE
+            trace.loop.record(co_trace::now_ns() - loop_start);
+#endif
+        }
+        make_current(prev);
+    }
+
+    // ────────────────────────────────────────────────
+    //  跨线程接口（任意线程可调用）
+    // ────────────────────────────────────────────────
+
+    // 把协程交给本 reactor 恢复。无锁入队，只有 reactor 可能在睡眠时才写 eventfd，
+    // 同一时刻每个 reactor 至多有一次未被消费的唤醒写。CO_TRACE 时就绪时间戳在入队时打上
+    void post(std::coroutine_handle<> h) {
+        if (!inject_queue.try_emplace(h)) {
+            // 注入环满（极少见），退化到加锁的溢出队列
+            std::lock_guard<std::mutex> lock(overflow_mutex);
+            overflow_queue.push_back(h);
+            overflow_size.fetch_add(1, std::memory_order_release);
+        }
+        notify();
+    }
+
+    // co_await reactor.schedule_from_any_thread()：把当前协程切换到本 reactor 线程上继续执行
+    struct AwaitSchedule {
+        Reactor& reactor;
+
+        bool await_ready() { return false; }
+        void await_suspend(std::coroutine_handle<> h) { reactor.post(h); }
+        void await_resume() {}
+    };
+
+    AwaitSchedule schedule_from_any_thread() { return {*this}; }
+
+    // 让 run() 在当前轮次结束后返回
+    void stop() {
+        stopped.store(true, std::memory_order_release);
+        notify();
+    }
+
+    // ────────────────────────────────────────────────
+    //  reactor 线程接口
+    // ────────────────────────────────────────────────
+
+    // 同线程直接入就绪队列，不经过 eventfd
+    void schedule(std::coroutine_handle<> h) { ready_queue.push_back(h); }
+
+    // 记录协程在 loc 处挂起（CO_TRACE 关闭时为空）。只能在本 reactor 线程调用
+    void trace_suspend([[maybe_unused]] std::coroutine_handle<> h, [[maybe_unused]] const std::source_location& loc) {
+#if CO_TRACE
+        suspended[h.address()] = {co_trace::now_ns(), trace.sites.find_or_insert(loc)};
+#endif
+    }
+
+    struct AwaitFd {
+        Reactor& reactor;
+        int fd;
+        uint32_t events;
+        std::source_location loc;
+
+        bool await_ready() { return false; }
+
+        void await_suspend(std::coroutine_handle<> h) {
+            reactor.waiting_coros[fd] = h;
+            reactor.trace_suspend(h, loc);
+
+            auto it = reactor.registered_fds.find(fd);
+            if (it == reactor.registered_fds.end()) {
+                epoll_event ev{};
+                ev.events = events | EPOLLET;
+                ev.data.fd = fd;
+                if (epoll_ctl(reactor.epfd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+                    throw std::runtime_error("epoll_ctl add failed");
+                }
+                reactor.registered_fds.emplace(fd, events);
+            } else if ((events & ~it->second) != 0) {
+                // 新的事件类型（例如读之后又要等可写），合并后 MOD，之后不再改
+                it->second |= events;
+                epoll_event ev{};
+                ev.events = it->second | EPOLLET;
+                ev.data.fd = fd;
+                if (epoll_ctl(reactor.epfd, EPOLL_CTL_MOD, fd, &ev) == -1) {
+                    throw std::runtime_error("epoll_ctl mod failed");
+                }
+            }
+        }
+
+        void await_resume() {}
+    };
+
+    AwaitFd await_event(int fd, uint32_t events, std::source_location loc = std::source_location::current()) {
+        return {*this, fd, events, loc};
+    }
+
+    // close(fd) 之前调用：清掉注册信息，避免 fd 号被复用时沿用旧状态
+    void remove_fd(int fd) {
+        if (registered_fds.erase(fd) > 0) {
+            epoll_ctl(epfd, EPOLL_CTL_DEL, fd, nullptr);
+        }
+        waiting_coros.erase(fd);
+    }
+
+    // 统计：真正写了 eventfd 的次数（合并之后）
+    size_t wakeup_writes() const noexcept { return wakeups.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t INJECT_CAPACITY = 1 << 12;
+    static constexpr size_t INJECT_BATCH = 256;
+
+    // 也是注入队列的元素，跨线程 post 时在投递线程上打时间戳
+    struct ReadyEntry {
+        ReadyEntry() = default;  // 只给 try_pop 当输出参数
+        ReadyEntry(std::coroutine_handle<> h_) : h(h_) {}
+
+        std::coroutine_handle<> h;
+        [[no_unique_address]] co_trace::Stamp enqueued;  // CO_TRACE 关闭时不占空间
+    };
+
+    void resume(const ReadyEntry& entry) {
+#if CO_TRACE
+        const uint64_t start = co_trace::now_ns();
+        trace.ready_delay.record(start - entry.enqueued.ns);
+
+        co_trace::SiteTable::Site* site = nullptr;
+        if (auto it = suspended.find(entry.h.address()); it != suspended.end()) {
+            site = it->second.site;
+            if (site) site->suspended.record(start - it->second.ns);
+            suspended.erase(it);
+        }
+
+        entry.h.resume();
+
+        const uint64_t took = co_trace::now_ns() - start;
+        trace.run_time.record(took);
+        const uint64_t threshold = co_trace::slow_resume_threshold_ns.load(std::memory_order_relaxed);
+        if (threshold != 0 && took > threshold) {
+            if (site) {
+                fprintf(stderr, "[co_trace] slow resume %.3f ms after co_await at %s:%u (%s)\n", took / 1e6,
+                        site->file, site->line, site->function);
+            } else {
+                fprintf(stderr, "[co_trace] slow resume %.3f ms (untracked suspension point)\n", took / 1e6);
+            }
+        }
+#else
+        entry.h.resume();
+#endif
+    }
+
+    int wait_events(epoll_event* events, int max, int timeout) {
+#if CO_TRACE
+        const uint64_t start = co_trace::now_ns();
+        int n = epoll_wait(epfd, events, max, timeout);
+        trace.epoll_wait.record(co_trace::now_ns() - start);
+        if (n >= 0) trace.events.record(n);
+        return n;
+#else
+        return epoll_wait(epfd, events, max, timeout);
+#endif
+    }
+
+    void notify() {
+        // 入队与读标志之间需要 StoreLoad 屏障，和 consume_wakeup 的 exchange 配对，否则可能丢唤醒。
+        // 已有未消费的唤醒时只读不写，避免多个生产者争抢同一条 cache line
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (wake_pending.load(std::memory_order_relaxed)) return;
+        if (wake_pending.exchange(true, std::memory_order_acq_rel)) return;
+
+        wakeups.fetch_add(1, std::memory_order_relaxed);
+        uint64_t one = 1;
+        ssize_t r = write(wake_fd, &one, sizeof(one));
+        (void) r;  // EAGAIN 说明计数器已非零，reactor 必然会被唤醒
+    }
+
+    void consume_wakeup() {
+        uint64_t cnt;
+        ssize_t r = read(wake_fd, &cnt, sizeof(cnt));
+        (void) r;
+        // 必须在搬运注入队列之前清标志：之后的 post 会重新写 eventfd。
+        // 用 seq_cst RMW 与生产者的 exchange / fence 同步，保证其入队的数据本轮可见
+        wake_pending.exchange(false, std::memory_order_seq_cst);
+    }
+
+    // 返回 true 表示注入队列里还有没搬完的协程
+    bool drain_injected() {
+        ReadyEntry entry;
+        size_t n = 0;
+        while (n < INJECT_BATCH && inject_queue.try_pop(entry)) {
+            ready_queue.push_back(entry);
+            ++n;
+        }
+
+        if (overflow_size.load(std::memory_order_acquire) > 0) {
+            std::lock_guard<std::mutex> lock(overflow_mutex);
+            for (auto oh : overflow_queue) {
+                ready_queue.push_back(oh);
+            }
+            overflow_size.fetch_sub(overflow_queue.size(), std::memory_order_relaxed);
+            overflow_queue.clear();
+        }
+        return !inject_queue.empty();
+    }
+
+    int epfd;
+    int wake_fd;
+    std::atomic<bool> stopped{false};
+    std::deque<ReadyEntry> ready_queue;
+    std::unordered_map<int, std::coroutine_handle<>> waiting_coros;
+    std::unordered_map<int, uint32_t> registered_fds;  // fd -> 已注册的事件集合
+
+    // 跨线程注入：多生产者 / reactor 单消费者
+    MpmcRingBuffer<ReadyEntry, INJECT_CAPACITY> inject_queue;
+    alignas(64) std::atomic<bool> wake_pending{false};
+    // 不用分片计数：notify 已经合并过，写得很少；而且它会在 SIGINT 处理函数里被调用（stop），
+    // 分片计数第一次用时要注册线程槽位（加锁、分配），不是信号安全的
+    alignas(64) std::atomic<size_t> wakeups{0};
+    std::atomic<size_t> overflow_size{0};
+    std::mutex overflow_mutex;
+    std::deque<ReadyEntry> overflow_queue;
+
+#if CO_TRACE
+    co_trace::LoopStats trace;
+    co_trace::SuspensionMap suspended;  // 协程帧地址 -> 挂起位置和时间
+#endif
+
+    static void make_current(Reactor* r) {
+        current_reactor = r;
+#if CO_TRACE
+        co_trace::current_suspensions = r ? &r->suspended : nullptr;
+#endif
+    }
+
+    static inline thread_local Reactor* current_reactor = nullptr;
+};
+
+#endif /* __CO_REACTOR__ */
@@ -0,0 +1,216 @@
+#ifndef __CO_TRACE__
+#define __CO_TRACE__
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <source_location>
+#include <unordered_map>
+#include <vector>
+
+// Reactor 延迟埋点，编译期开关：-DCO_TRACE=1（CMake: -DCO_TRACE=ON）。
+// 关闭时 Stamp / Token 都是空类型、钩子是空内联函数，不占空间也不产生指令。
+//
+// 打开后每个 reactor（即每个线程）记录：
+//   ready_delay   协程变为就绪到被恢复的时间；从别的线程 post 过来的从进注入队列时算起，包含跨线程唤醒
+//   run_time      每次 resume 的运行时间
+//   suspended     按 co_await 位置统计的挂起时间（协程没有名字，生命周期又短，按挂起位置归类）
+//   epoll_wait    每次 epoll_wait 阻塞的时间
+//   events        每次 epoll_wait 返回的事件数
+//   loop          每轮事件循环的总时间
+// 直方图只由所属 reactor 线程写（relaxed load + store），dump 可在任意线程无锁读取。
+#ifndef CO_TRACE
+#define CO_TRACE 0
+#endif
+
+namespace co_trace {
+
+inline uint64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// 以 2 为底的对数分桶，单写者
+class Log2Histogram {
+public:
+    static constexpr int BUCKETS = 64;
+
+    void record(uint64_t v) {
+        int b = v == 0 ? 0 : 64 - std::countl_zero(v);
+        if (b >= BUCKETS) b = BUCKETS - 1;
+        bump(buckets_[b], 1);
+        bump(count_, 1);
+        bump(sum_, v);
+        if (v > max_.load(std::memory_order_relaxed)) max_.store(v, std::memory_order_relaxed);
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+    // 返回所在桶的上界，误差在 2 倍以内
+    uint64_t percentile(double p) const {
+        uint64_t total = count();
+        if (total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(p * total);
+        uint64_t seen = 0;
+        for (int b = 0; b < BUCKETS; ++b) {
+            seen += buckets_[b].load(std::memory_order_relaxed);
+            if (seen > rank) return b == 0 ? 0 : (uint64_t(1) << b) - 1;
+        }
+        return max_.load(std::memory_order_relaxed);
+    }
+
+    void print(FILE* out, const char* name, const char* unit) const {
+        uint64_t n = count();
+        if (n == 0) return;
+        fprintf(out, "  %-24s n=%-10llu avg=%-10.1f p50<=%-10llu p99<=%-10llu p999<=%-10llu max=%llu %s\n", name,
+                (unsigned long long) n, double(sum_.load(std::memory_order_relaxed)) / n,
+                (unsigned long long) percentile(0.5), (unsigned long long) percentile(0.99),
+                (unsigned long long) percentile(0.999), (unsigned long long) max_.load(std::memory_order_relaxed), unit);
+    }
+
+private:
+    static void bump(std::atomic<uint64_t>& a, uint64_t d) {
+        a.store(a.load(std::memory_order_relaxed) + d, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> buckets_[BUCKETS]{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+// co_await 位置 → 挂起时间直方图。固定大小开放寻址表，owner 线程插入，key 用 release 发布
+class SiteTable {
+public:
+    static constexpr size_t SLOTS = 64;
+
+    struct Site {
+        std::atomic<uint64_t> key{0};
+        const char* file = nullptr;
+        const char* function = nullptr;
+        uint32_t line = 0;
+        Log2Histogram suspended;
+    };
+
+    // 表满时返回 nullptr，该位置不再统计
+    Site* find_or_insert(const std::source_location& loc) {
+        uint64_t key = make_key(loc);
+        size_t i = key % SLOTS;
+        for (size_t probe = 0; probe < SLOTS; ++probe, i = (i + 1) % SLOTS) {
+            uint64_t k = sites_[i].key.load(std::memory_order_relaxed);
+            if (k == key) return &sites_[i];
+            if (k == 0) {
+                sites_[i].file = loc.file_name();
+                sites_[i].function = loc.function_name();
+                sites_[i].line = loc.line();
+                sites_[i].key.store(key, std::memory_order_release);
+                return &sites_[i];
+            }
+        }
+        return nullptr;
+    }
+
+    void print(FILE* out) const {
+        for (const auto& s : sites_) {
+            if (s.key.load(std::memory_order_acquire) == 0) continue;
+            fprintf(out, "  suspended @ %s:%u (%s)\n", s.file, s.line, s.function);
+            s.suspended.print(out, "", "ns");
+        }
+    }
+
+private:
+    static uint64_t make_key(const std::source_location& loc) {
+        uint64_t k = reinterpret_cast<uintptr_t>(loc.file_name()) * 0x9E3779B97F4A7C15ULL ^ loc.line();
+        return k == 0 ? 1 : k;
+    }
+
+    Site sites_[SLOTS];
+};
+
+struct LoopStats {
+    Log2Histogram ready_delay;
+    Log2Histogram run_time;
+    Log2Histogram epoll_wait;
+    Log2Histogram events;
+    Log2Histogram loop;
+    SiteTable sites;
+
+    void print(FILE* out) const {
+        ready_delay.print(out, "ready_delay", "ns");
+        run_time.print(out, "run_time", "ns");
+        epoll_wait.print(out, "epoll_wait", "ns");
+        events.print(out, "events_per_wait", "events");
+        loop.print(out, "loop_iteration", "ns");
+        sites.print(out);
+    }
+};
+
+// 所有存活 reactor 的统计，只在注册 / 注销 / dump 时加锁
+struct Registry {
+    std::mutex mu;
+    std::vector<const LoopStats*> loops;
+};
+
+inline Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+inline void register_loop(const LoopStats* s) {
+    std::lock_guard<std::mutex> lock(registry().mu);
+    registry().loops.push_back(s);
+}
+
+inline void unregister_loop(const LoopStats* s) {
+    std::lock_guard<std::mutex> lock(registry().mu);
+    std::erase(registry().loops, s);
+}
+
+// 打印所有 reactor 的直方图；CO_TRACE 关闭时什么都不输出
+inline void dump(FILE* out = stderr) {
+    std::lock_guard<std::mutex> lock(registry().mu);
+    for (size_t i = 0; i < registry().loops.size(); ++i) {
+        fprintf(out, "[co_trace] reactor #%zu\n", i);
+        registry().loops[i]->print(out);
+    }
+}
+
+// 单次 resume 超过阈值时打印它是从哪个 co_await 位置恢复的，0 表示不打印
+inline std::atomic<uint64_t> slow_resume_threshold_ns{0};
+
+inline void set_slow_resume_threshold(std::chrono::nanoseconds t) {
+    slow_resume_threshold_ns.store(t.count(), std::memory_order_relaxed);
+}
+
+#if CO_TRACE
+// 入就绪队列的时间戳
+struct Stamp {
+    uint64_t ns = now_ns();
+};
+
+// 协程挂起时记下的位置和时间
+struct Suspension {
+    uint64_t ns;
+    SiteTable::Site* site;
+};
+
+// 协程帧地址 -> 挂起记录，每个 reactor 一张；current_suspensions 指向本线程当前 reactor 的那张
+using SuspensionMap = std::unordered_map<void*, Suspension>;
+inline thread_local SuspensionMap* current_suspensions = nullptr;
+#else
+struct Stamp {};
+#endif
+
+// 协程帧释放时调用（Task / Async 的 operator delete，参数就是帧地址）。
+// 在挂起中被销毁的协程不会再经过 resume，要在这里删掉它的挂起记录，否则表只增不减
+inline void frame_destroyed([[maybe_unused]] void* frame) {
+#if CO_TRACE
+    if (current_suspensions) current_suspensions->erase(frame);
+#endif
+}
+
+}  // namespace co_trace
+
+#endif /* __CO_TRACE__ */
@@ -1,151 +1,45 @@
-#include <exception>
 #include <sys/epoll.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <csignal>
+#include <cstdio>
 #include <cstring>
-#include <deque>
-#include <unordered_map>
-#include <unordered_set>
-#include <coroutine>
 #include <iostream>
 #include <stdexcept>
 
-struct Task {
-    struct promise_type {
-        Task get_return_object() { return Task{std::coroutine_handle<promise_type>::from_promise(*this)}; }
-        std::suspend_never initial_suspend() { return {}; }
-        std::suspend_always final_suspend() noexcept { return {}; }
-        void return_void() {}
-        void unhandled_exception() { std::terminate(); }
-    };
-    std::coroutine_handle<promise_type> h;
-    explicit Task(std::coroutine_handle<promise_type> h_) : h(h_) {}
-    ~Task() { if (h) h.destroy(); }
-    void resume() { if (h && !h.done()) h.resume(); }
-    bool done() const { return !h || h.done(); }
-};
-
-class Reactor {
-public:
-    Reactor() {
-        epfd = epoll_create1(0);
-        if (epfd == -1) throw std::runtime_error("epoll_create1 failed");
-    }
-
-    ~Reactor() { close(epfd); }
-
-    void run() {
-        while (true) {
-            // 处理就绪协程队列
-            while (!ready_queue.empty()) {
-                auto h = ready_queue.front();
-                ready_queue.pop_front();
-                h.resume();
-            }
-
-            epoll_event events[128];
-            int n = epoll_wait(epfd, events, 128, -1);
-            if (n == -1) break;
-
-            for (int i = 0; i < n; ++i) {
-                int fd = events[i].data.fd;
-                // uint32_t ev = events[i].events; // 可以根据 ev 处理错误等
-
-                auto it = waiting_coros.find(fd);
-                if (it != waiting_coros.end()) {
-                    ready_queue.push_back(it->second);
-                    // 不清除 waiting_coros, 因为协程消费后会再次 co_await 设置
-                }
-            }
-        }
-    }
-
-    struct AwaitFd {
-        Reactor& reactor;
-        int fd;
-        uint32_t events;
-
-        bool await_ready() { return false; }
-
-        void await_suspend(std::coroutine_handle<> h) {
-            reactor.waiting_coros[fd] = h;
+#include "AsyncStream.h"
+#include "Histogram.h"
+#include "Log.h"
+#include "Reactor.h"
+#include "Topology.h"
+#include "Tsc.h"
 
-            if (reactor.registered_fds.find(fd) == reactor.registered_fds.end()) {
-                epoll_event ev{};
-                ev.events = events | EPOLLET;
-                ev.data.fd = fd;
-                if (epoll_ctl(reactor.epfd, EPOLL_CTL_ADD, fd, &ev) == -1) {
-                    throw std::runtime_error("epoll_ctl add failed");
-                }
-                reactor.registered_fds.insert(fd);
-            }
-            // 如果 events 变了，可以 EPOLL_CTL_MOD，但这里假设 events 固定
-        }
-
-        void await_resume() {}
-    };
-
-    AwaitFd await_event(int fd, uint32_t events) {
-        return {*this, fd, events};
-    }
-
-private:
-    int epfd;
-    std::deque<std::coroutine_handle<>> ready_queue;
-    std::unordered_map<int, std::coroutine_handle<>> waiting_coros;
-    std::unordered_set<int> registered_fds;
-};
+// 每行请求从取出到回应写进 socket 的时间（TSC 周期），只由 reactor 线程记录
+static stats::Histogram echo_latency;
 
 Task echo_server(Reactor& reactor, int client_fd) {
-    char buf[1024];
-    while (true) {
-        co_await reactor.await_event(client_fd, EPOLLIN | EPOLLET);
-
-        // 循环读直到 EAGAIN (ET 要求)
-        ssize_t n = 0;
-        while (true) {
-            ssize_t r = read(client_fd, buf + n, sizeof(buf) - n);
-            if (r > 0) {
-                buf[n + 1] = '\0';
-                printf("read: %s", buf);
-                n += r;
-            } else if (r == 0) {
-                break;
-            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                break;
-            } else {
-                n = -1; // 错误
-                break;
-            }
-        }
-        if (n <= 0) break;
-
-        // 循环写直到 EAGAIN
-        ssize_t sent = 0;
-        while (sent < n) {
-            co_await reactor.await_event(client_fd, EPOLLOUT);
-
-            ssize_t w = 0;
-            while (true) {
-                ssize_t ww = write(client_fd, buf + sent + w, n - sent - w);
-                if (ww > 0) {
-                    w += ww;
-                } else if (ww == 0) {
-                    break;
-                } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                    break;
-                } else {
-                    w = -1;
-                    break;
-                }
-            }
-            if (w <= 0) break;
-            sent += w;
+    AsyncStream stream(reactor, client_fd);
+    LineFramer framer(stream);
+
+    // 缓冲区里已有的多行（流水线请求）依次取出并排队回写，取完后一次 writev 全部发出；
+    // 同一批里每行的延迟都从取出第一行时算起
+    while (auto line = co_await framer.next()) {
+        const uint64_t start = stats::tsc_now();
+        size_t lines = 0;
+        do {
+            ALOG("read: %s", *line);
+            framer.send(*line);
+            ++lines;
+        } while (framer.try_next(line) && line);
+        if (!co_await stream.flush()) break;
+        const uint64_t took = stats::tsc_now() - start;
+        for (size_t i = 0; i < lines; ++i) {
+            echo_latency.record(took);
         }
     }
-    close(client_fd);
+    co_await stream.flush();
 }
 
 Task acceptor(Reactor& reactor, int listen_fd) {
@@ -162,17 +56,31 @@ Task acceptor(Reactor& reactor, int listen_fd) {
 
             fcntl(client_fd, F_SETFL, fcntl(client_fd, F_GETFL) | O_NONBLOCK);
 
-            // 启动 echo 协程
-            Task echo = echo_server(reactor, client_fd);
-            echo.resume();
+            // 启动 echo 协程，连接结束后协程帧自行释放
+            echo_server(reactor, client_fd).detach();
         }
     }
 }
 
-int main() {
+static Reactor* g_reactor = nullptr;
+
+int main(int argc, char** argv) {
+    topo::parse_args(argc, argv);
+    // 请求日志交给后台线程，reactor 线程上只剩几十纳秒的入环。
+    // 在绑核之前启动，后台线程不继承事件循环的亲和性
+    alog::start();
+    // --pin=<策略> 时把 reactor 线程绑到策略给的第一个 CPU 上
+    topo::pin_current(0, 1);
     try {
         Reactor reactor;
 
+        // Ctrl-C 时让 run() 返回，便于打印埋点统计（stop 只做原子操作和 eventfd 写，信号安全）
+        g_reactor = &reactor;
+        signal(SIGINT, [](int) { g_reactor->stop(); });
+#if CO_TRACE
+        co_trace::set_slow_resume_threshold(std::chrono::milliseconds(1));
+#endif
+
         int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
         if (listen_fd == -1) throw std::runtime_error("socket failed");
         int opt = 1;
@@ -195,6 +103,9 @@ int main() {
         std::cout << "Server listening on :8080" << std::endl;
 
         reactor.run();
+        alog::stop();
+        echo_latency.snapshot().print(stdout, "echo_latency", "ns", stats::tsc_per_ns());
+        co_trace::dump();
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
     }
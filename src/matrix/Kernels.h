@@ -0,0 +1,122 @@
+#ifndef __MATRIX_KERNELS__
+#define __MATRIX_KERNELS__
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "Matrix.h"
+
+// 按块处理的矩阵内核。块边长就是矩阵自己的块边长（默认由 tile_edge 按 L1 大小选出），
+// 参与运算的矩阵必须用同一个块边长，布局可以不同：内核只通过 tile_view 拿到"块首地址 + 行距"，
+// 行优先、分块、Morton 三种布局共用同一份代码
+namespace mat {
+
+namespace detail {
+
+template<typename T>
+void transpose_tile(TileView<const T> s, TileView<T> d, size_t edge) {
+    for (size_t r = 0; r < edge; ++r) {
+        const T* src = s.row(r);
+        for (size_t c = 0; c < edge; ++c) {
+            d.row(c)[r] = src[c];
+        }
+    }
+}
+
+// c += a * b，三个块都在 L1 里。每次取 c 的 4 行、k 方向 2 步：读一遍 b 的两行更新 c 的四行，
+// c 的每次读写摊到 4 次乘加上（逐行逐 k 的写法是 1 次），瓶颈从 load/store 回到乘加。
+// 最内层用 GCC 向量扩展按 16 字节一组写出来：交给自动向量化时，块边长一旦被常量传播进来，
+// 循环就会被整个展开成标量代码，性能反而掉一半。块边长是 2 的幂，至少是一组的宽度
+template<typename T>
+void multiply_tile(TileView<const T> a, TileView<const T> b, TileView<T> c, size_t edge) {
+    typedef T Vec __attribute__((vector_size(16), aligned(alignof(T)), may_alias));
+    constexpr size_t WIDTH = sizeof(Vec) / sizeof(T);
+    assert(edge % WIDTH == 0);
+    auto vec = [](const T* p) { return *reinterpret_cast<const Vec*>(p); };
+    auto out = [](T* p) -> Vec& { return *reinterpret_cast<Vec*>(p); };
+    for (size_t i = 0; i < edge; i += 4) {
+        T* c0 = c.row(i);
+        T* c1 = c.row(i + 1);
+        T* c2 = c.row(i + 2);
+        T* c3 = c.row(i + 3);
+        const T* a0 = a.row(i);
+        const T* a1 = a.row(i + 1);
+        const T* a2 = a.row(i + 2);
+        const T* a3 = a.row(i + 3);
+        for (size_t k = 0; k < edge; k += 2) {
+            const T* b0 = b.row(k);
+            const T* b1 = b.row(k + 1);
+            const T x00 = a0[k], x01 = a0[k + 1];
+            const T x10 = a1[k], x11 = a1[k + 1];
+            const T x20 = a2[k], x21 = a2[k + 1];
+            const T x30 = a3[k], x31 = a3[k + 1];
+            for (size_t j = 0; j < edge; j += WIDTH) {
+                const Vec y0 = vec(b0 + j), y1 = vec(b1 + j);
+                out(c0 + j) += x00 * y0 + x01 * y1;
+                out(c1 + j) += x10 * y0 + x11 * y1;
+                out(c2 + j) += x20 * y0 + x21 * y1;
+                out(c3 + j) += x30 * y0 + x31 * y1;
+            }
+        }
+    }
+}
+
+}  // namespace detail
+
+// dst = src^T，dst 须是 cols × rows
+template<typename T, Layout LS, Layout LD>
+void transpose(const Matrix<T, LS>& src, Matrix<T, LD>& dst) {
+    assert(dst.rows() == src.cols() && dst.cols() == src.rows() && dst.tile() == src.tile());
+    const size_t edge = src.tile();
+    for (size_t ti = 0; ti < src.tile_rows(); ++ti) {
+        for (size_t tj = 0; tj < src.tile_cols(); ++tj) {
+            detail::transpose_tile(src.tile_view(ti, tj), dst.tile_view(tj, ti), edge);
+        }
+    }
+}
+
+// 每一列的和。按块行扫描，每个块把自己那一段累加器（edge 个元素）留在 L1 里加完 edge 行，
+// 而不是一列一列地跨行访问
+template<typename T, Layout L>
+std::vector<T> column_sums(const Matrix<T, L>& m) {
+    const size_t edge = m.tile();
+    std::vector<T> sums(m.tile_cols() * edge, T{});
+    for (size_t ti = 0; ti < m.tile_rows(); ++ti) {
+        for (size_t tj = 0; tj < m.tile_cols(); ++tj) {
+            auto v = m.tile_view(ti, tj);
+            T* __restrict acc = sums.data() + tj * edge;
+            for (size_t r = 0; r < edge; ++r) {
+                const T* row = v.row(r);
+                for (size_t c = 0; c < edge; ++c) {
+                    acc[c] += row[c];
+                }
+            }
+        }
+    }
+    sums.resize(m.cols());
+    return sums;
+}
+
+// c = a * b，c 须是 a.rows() × b.cols()，原内容被覆盖
+template<typename T, Layout LA, Layout LB, Layout LC>
+void multiply(const Matrix<T, LA>& a, const Matrix<T, LB>& b, Matrix<T, LC>& c) {
+    assert(a.cols() == b.rows() && c.rows() == a.rows() && c.cols() == b.cols());
+    assert(a.tile() == b.tile() && b.tile() == c.tile());
+    const size_t edge = a.tile();
+    for (size_t ti = 0; ti < c.tile_rows(); ++ti) {
+        for (size_t tj = 0; tj < c.tile_cols(); ++tj) {
+            auto cv = c.tile_view(ti, tj);
+            for (size_t r = 0; r < edge; ++r) {
+                std::fill_n(cv.row(r), edge, T{});
+            }
+            for (size_t tk = 0; tk < a.tile_cols(); ++tk) {
+                detail::multiply_tile(a.tile_view(ti, tk), b.tile_view(tk, tj), cv, edge);
+            }
+        }
+    }
+}
+
+}  // namespace mat
+
+#endif /* __MATRIX_KERNELS__ */
@@ -0,0 +1,174 @@
+#ifndef __MATRIX_MATRIX__
+#define __MATRIX_MATRIX__
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+// 一整块连续内存的矩阵，布局可选：
+//   RowMajor  普通行优先，行距按块边长向上取整；行距正好是 4K 的倍数时再多加一个缓存行，
+//             否则按块访问时同一块的各行落在同一组缓存集合上，互相驱逐
+//   Tiled     按 B×B 的块存，块与块之间行优先，块内行优先
+//   Morton    块内行优先，块与块之间按 Z 序（Morton 序）排列：相邻的块在内存里也尽量相邻，
+//             对任意大小的子矩阵都保持局部性。逐元素的 Z 序没法给内核一个带步长的块视图，所以只在块这一级交织
+// 所有布局都把行列数补齐到块边长的整数倍（Morton 还要补成 2 的幂的方阵块网格），补齐部分为 0，
+// 因此下面的内核总是整块处理，没有边角分支
+namespace mat {
+
+enum class Layout { RowMajor, Tiled, Morton };
+
+inline const char* layout_name(Layout layout) {
+    switch (layout) {
+        case Layout::RowMajor: return "row_major";
+        case Layout::Tiled: return "tiled";
+        case Layout::Morton: return "morton";
+    }
+    return "?";
+}
+
+// 由 sysconf 读到的缓存大小，读不到时取常见值
+struct CacheGeometry {
+    size_t l1d;
+    size_t l2;
+    size_t line;
+
+    static const CacheGeometry& get() {
+        static const CacheGeometry g = [] {
+            auto query = [](int name, size_t fallback) {
+                long v = sysconf(name);
+                return v > 0 ? static_cast<size_t>(v) : fallback;
+            };
+            return CacheGeometry{query(_SC_LEVEL1_DCACHE_SIZE, 32 << 10), query(_SC_LEVEL2_CACHE_SIZE, 1 << 20),
+                                 query(_SC_LEVEL1_DCACHE_LINESIZE, 64)};
+        }();
+        return g;
+    }
+};
+
+// 让 tiles 个 B×B 的块同时放进 L1 的最大 2 的幂 B（至少 8）。
+// 乘法要 A / B / C 各一块，转置要源和目标各一块
+template<typename T>
+size_t tile_edge(size_t tiles = 3) {
+    size_t edge = 8;
+    while (tiles * (2 * edge) * (2 * edge) * sizeof(T) <= CacheGeometry::get().l1d) {
+        edge *= 2;
+    }
+    return edge;
+}
+
+// 指向一个 B×B 块左上角，行与行之间相隔 stride 个元素
+template<typename T>
+struct TileView {
+    T* p;
+    size_t stride;
+
+    T* row(size_t r) const { return p + r * stride; }
+};
+
+namespace detail {
+
+// 把 x 的各位隔位摊开：...b2b1b0 → ...0b2 0b1 0b0
+inline uint64_t spread_bits(uint32_t x) {
+    uint64_t v = x;
+    v = (v | (v << 16)) & 0x0000FFFF0000FFFFULL;
+    v = (v | (v << 8)) & 0x00FF00FF00FF00FFULL;
+    v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    v = (v | (v << 2)) & 0x3333333333333333ULL;
+    v = (v | (v << 1)) & 0x5555555555555555ULL;
+    return v;
+}
+
+inline uint64_t morton(uint32_t row, uint32_t col) {
+    return (spread_bits(row) << 1) | spread_bits(col);
+}
+
+struct FreeDeleter {
+    void operator()(void* p) const { std::free(p); }
+};
+
+}  // namespace detail
+
+template<typename T, Layout L = Layout::RowMajor>
+class Matrix {
+public:
+    static constexpr Layout layout = L;
+
+    // tile 必须是 2 的幂，默认由 L1 大小决定
+    Matrix(size_t rows, size_t cols, size_t tile = tile_edge<T>()) : rows_(rows), cols_(cols) {
+        shift_ = std::countr_zero(tile);
+        tile_rows_ = (rows + tile - 1) >> shift_;
+        tile_cols_ = (cols + tile - 1) >> shift_;
+        size_t bytes;
+        if constexpr (L == Layout::RowMajor) {
+            ld_ = tile_cols_ << shift_;
+            if ((ld_ * sizeof(T)) % 4096 == 0) ld_ += 64 / sizeof(T);
+            bytes = (tile_rows_ << shift_) * ld_ * sizeof(T);
+        } else if constexpr (L == Layout::Morton) {
+            // Z 序下块网格必须是 2 的幂的方阵，多出来的块只占地址不会被访问到
+            size_t grid = std::bit_ceil(std::max(tile_rows_, tile_cols_));
+            bytes = grid * grid * (tile << shift_) * sizeof(T);
+        } else {
+            bytes = tile_rows_ * tile_cols_ * (tile << shift_) * sizeof(T);
+        }
+        bytes = (bytes + 63) & ~size_t(63);
+        data_.reset(static_cast<T*>(std::aligned_alloc(64, bytes)));
+        memset(data_.get(), 0, bytes);
+    }
+
+    Matrix(Matrix&&) noexcept = default;
+    Matrix& operator=(Matrix&&) noexcept = default;
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    size_t tile() const { return size_t(1) << shift_; }
+    size_t tile_rows() const { return tile_rows_; }
+    size_t tile_cols() const { return tile_cols_; }
+
+    T& at(size_t i, size_t j) { return data_.get()[offset(i, j)]; }
+    const T& at(size_t i, size_t j) const { return data_.get()[offset(i, j)]; }
+
+    TileView<T> tile_view(size_t ti, size_t tj) {
+        if constexpr (L == Layout::RowMajor) {
+            return {data_.get() + (ti << shift_) * ld_ + (tj << shift_), ld_};
+        } else {
+            return {data_.get() + (tile_index(ti, tj) << (2 * shift_)), tile()};
+        }
+    }
+    TileView<const T> tile_view(size_t ti, size_t tj) const {
+        auto v = const_cast<Matrix*>(this)->tile_view(ti, tj);
+        return {v.p, v.stride};
+    }
+
+private:
+    size_t tile_index(size_t ti, size_t tj) const {
+        if constexpr (L == Layout::Morton) {
+            return detail::morton(static_cast<uint32_t>(ti), static_cast<uint32_t>(tj));
+        } else {
+            return ti * tile_cols_ + tj;
+        }
+    }
+
+    size_t offset(size_t i, size_t j) const {
+        if constexpr (L == Layout::RowMajor) {
+            return i * ld_ + j;
+        } else {
+            const size_t mask = tile() - 1;
+            return (tile_index(i >> shift_, j >> shift_) << (2 * shift_)) + ((i & mask) << shift_) + (j & mask);
+        }
+    }
+
+    size_t rows_, cols_;
+    unsigned shift_;
+    size_t tile_rows_, tile_cols_;
+    size_t ld_ = 0;  // 只用于 RowMajor
+    std::unique_ptr<T[], detail::FreeDeleter> data_;
+};
+
+}  // namespace mat
+
+#endif /* __MATRIX_MATRIX__ */
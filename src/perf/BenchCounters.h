@@ -0,0 +1,45 @@
+#ifndef __PERF_BENCHCOUNTERS__
+#define __PERF_BENCHCOUNTERS__
+#include <benchmark/benchmark.h>
+
+#include "PerfCounters.h"
+
+// 把 PerfGroup 接到 Google Benchmark 上。在基准函数里、for (auto _ : state) 之前放一行
+//
+//     perf::BenchCounters perf_counters(state);
+//
+// 从构造到函数返回之间本线程的事件计数会作为用户计数器出现在结果里，所以它之前的准备工作不计入，
+// 循环之后的收尾会计入，收尾重的基准应把它放进单独的作用域。
+// 多线程基准每个线程各自计数，框架把各线程的值相加后再除以总迭代数（各线程迭代数之和），
+// 得到的是"一个线程跑一次迭代"的平均值；IPC 是每个线程单独算出来再取平均。
+// 事件打不开时什么也不加，基准照常运行；只统计了用户态时加一个 user_only=1，免得被当成完整的计数
+namespace perf {
+
+inline void report(benchmark::State& state, const Sample& s) {
+    for (size_t i = 0; i < EVENT_COUNT; ++i) {
+        Event e = static_cast<Event>(i);
+        if (s.has(e)) state.counters[event_name(e)] = benchmark::Counter(s[e], benchmark::Counter::kAvgIterations);
+    }
+    if (s.has(Event::Cycles) && s.has(Event::Instructions) && s[Event::Cycles] > 0) {
+        state.counters["IPC"] =
+            benchmark::Counter(s[Event::Instructions] / s[Event::Cycles], benchmark::Counter::kAvgThreads);
+    }
+    if (s.user_only) state.counters["user_only"] = benchmark::Counter(1, benchmark::Counter::kAvgThreads);
+}
+
+class BenchCounters {
+public:
+    explicit BenchCounters(benchmark::State& state) : state_(state) { group_.start(); }
+    ~BenchCounters() { report(state_, group_.stop()); }
+
+    BenchCounters(const BenchCounters&) = delete;
+    BenchCounters& operator=(const BenchCounters&) = delete;
+
+private:
+    benchmark::State& state_;
+    PerfGroup group_;
+};
+
+}  // namespace perf
+
+#endif /* __PERF_BENCHCOUNTERS__ */
@@ -0,0 +1,243 @@
+#ifndef __PERF_PERFCOUNTERS__
+#define __PERF_PERFCOUNTERS__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// perf_event_open 的薄封装：只统计创建它的那个线程（pid = 0, cpu = -1），
+// 多线程的基准里每个线程各开一组。
+//
+// 硬件事件（周期、指令、L1D / LLC 未命中、分支预测失败）放一个组，组内同时启停、一次读出，
+// 比值（IPC、每千条指令的未命中）才有意义；软件事件（CPU 时间、上下文切换、迁移、缺页）另放一组。
+// 逐级退化：
+//   - perf_event_paranoid >= 2 时不能统计内核态，自动改为只统计用户态：stderr 上说一次，
+//     之后的 Sample::user_only 为 true（BenchCounters 会多一个 user_only 计数器）
+//   - 虚拟机 / 容器里没有 PMU 时硬件组整个打不开，只剩软件组
+//   - seccomp 禁了 perf_event_open 时什么都没有，Sample 为空
+//   - 计数器被复用（multiplexing）时按 time_enabled / time_running 放大
+// 环境变量 PERF_COUNTERS=0 时不打开任何事件
+namespace perf {
+
+enum class Event {
+    Cycles,
+    Instructions,
+    L1DMisses,
+    LLCMisses,
+    BranchMisses,
+    TaskClock,
+    ContextSwitches,
+    CpuMigrations,
+    PageFaults,
+    Count
+};
+
+constexpr size_t EVENT_COUNT = size_t(Event::Count);
+
+inline const char* event_name(Event e) {
+    switch (e) {
+        case Event::Cycles: return "cycles";
+        case Event::Instructions: return "instructions";
+        case Event::L1DMisses: return "L1D_miss";
+        case Event::LLCMisses: return "LLC_miss";
+        case Event::BranchMisses: return "branch_miss";
+        case Event::TaskClock: return "task_clock_ns";
+        case Event::ContextSwitches: return "ctx_switch";
+        case Event::CpuMigrations: return "migrations";
+        case Event::PageFaults: return "page_faults";
+        case Event::Count: break;
+    }
+    return "?";
+}
+
+// 一次测量的结果，没打开的事件 has() 为 false
+struct Sample {
+    std::array<double, EVENT_COUNT> value{};
+    uint32_t valid = 0;
+    bool user_only = false;  // 计数不含内核态
+
+    bool has(Event e) const { return valid & (1u << size_t(e)); }
+    double operator[](Event e) const { return value[size_t(e)]; }
+    bool empty() const { return valid == 0; }
+};
+
+namespace detail {
+
+struct EventSpec {
+    Event event;
+    uint32_t type;
+    uint64_t config;
+};
+
+constexpr uint64_t cache_config(uint64_t cache, uint64_t op, uint64_t result) {
+    return cache | (op << 8) | (result << 16);
+}
+
+// 每组第一个能打开的事件当组长
+constexpr EventSpec HARDWARE_EVENTS[] = {
+    {Event::Cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {Event::Instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {Event::L1DMisses, PERF_TYPE_HW_CACHE,
+     cache_config(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {Event::LLCMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {Event::BranchMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+constexpr EventSpec SOFTWARE_EVENTS[] = {
+    {Event::TaskClock, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+    {Event::ContextSwitches, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+    {Event::CpuMigrations, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS},
+    {Event::PageFaults, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+};
+
+inline bool disabled_by_env() {
+    const char* v = std::getenv("PERF_COUNTERS");
+    return v && (strcmp(v, "0") == 0 || strcmp(v, "off") == 0);
+}
+
+// 进程内只报告一次为什么退化了
+inline void report_once(const std::string& msg) {
+    static std::once_flag once;
+    std::call_once(once, [&] { fprintf(stderr, "perf: %s\n", msg.c_str()); });
+}
+
+// 退到只统计用户态之后为 true，进程内不再恢复
+inline std::atomic<bool> user_only{false};
+
+inline void fall_back_to_user_only() {
+    if (user_only.exchange(true, std::memory_order_relaxed)) return;
+    fprintf(stderr, "perf: kernel-mode counting not permitted (perf_event_paranoid), counting user space only\n");
+}
+
+// 一组同时启停的事件
+class EventGroup {
+public:
+    EventGroup() = default;
+    EventGroup(const EventGroup&) = delete;
+    EventGroup& operator=(const EventGroup&) = delete;
+    ~EventGroup() {
+        for (int fd : fds_) {
+            close(fd);
+        }
+    }
+
+    // 返回组长打开失败时的 errno，成功为 0
+    template<size_t N>
+    int open(const EventSpec (&specs)[N]) {
+        int leader_errno = 0;
+        for (const auto& spec : specs) {
+            int fd = open_event(spec, fds_.empty() ? -1 : fds_.front());
+            if (fd < 0) {
+                if (fds_.empty()) leader_errno = errno;
+                continue;
+            }
+            fds_.push_back(fd);
+            events_.push_back(spec.event);
+        }
+        return fds_.empty() ? leader_errno : 0;
+    }
+
+    bool empty() const { return fds_.empty(); }
+
+    void start() {
+        if (empty()) return;
+        ioctl(fds_.front(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds_.front(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    void stop(Sample& out) {
+        if (empty()) return;
+        ioctl(fds_.front(), PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        // PERF_FORMAT_GROUP 的布局：nr, time_enabled, time_running, value[nr]
+        std::vector<uint64_t> buf(3 + fds_.size());
+        ssize_t n = read(fds_.front(), buf.data(), buf.size() * sizeof(uint64_t));
+        if (n < ssize_t(3 * sizeof(uint64_t)) || buf[0] != fds_.size()) return;
+        const uint64_t enabled = buf[1], running = buf[2];
+        if (running == 0) return;
+        const double scale = double(enabled) / double(running);
+        for (size_t i = 0; i < events_.size(); ++i) {
+            out.value[size_t(events_[i])] = double(buf[3 + i]) * scale;
+            out.valid |= 1u << size_t(events_[i]);
+        }
+    }
+
+private:
+    // 先连内核态一起统计，不允许（EACCES / EPERM）就退到只统计用户态，结果缓存起来
+    static int open_event(const EventSpec& spec, int group_fd) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = spec.type;
+        attr.config = spec.config;
+        attr.disabled = group_fd == -1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        for (;;) {
+            attr.exclude_kernel = user_only.load(std::memory_order_relaxed);
+            int fd = int(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC));
+            if (fd >= 0) return fd;
+            if ((errno == EACCES || errno == EPERM) && !attr.exclude_kernel) {
+                fall_back_to_user_only();
+                continue;
+            }
+            return -1;
+        }
+    }
+
+    std::vector<int> fds_;
+    std::vector<Event> events_;
+};
+
+}  // namespace detail
+
+// 当前线程上的硬件组 + 软件组
+class PerfGroup {
+public:
+    PerfGroup() {
+        if (detail::disabled_by_env()) return;
+        int hw_errno = hardware_.open(detail::HARDWARE_EVENTS);
+        int sw_errno = software_.open(detail::SOFTWARE_EVENTS);
+        if (hw_errno != 0 && sw_errno != 0) {
+            detail::report_once(std::string("perf_event_open unavailable (") + strerror(sw_errno) +
+                                "), no counters");
+        } else if (hw_errno != 0) {
+            detail::report_once(std::string("hardware counters unavailable (") + strerror(hw_errno) +
+                                "), software events only");
+        }
+    }
+
+    bool empty() const { return hardware_.empty() && software_.empty(); }
+    bool hardware() const { return !hardware_.empty(); }
+
+    void start() {
+        hardware_.start();
+        software_.start();
+    }
+
+    Sample stop() {
+        Sample s;
+        hardware_.stop(s);
+        software_.stop(s);
+        s.user_only = !s.empty() && detail::user_only.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    detail::EventGroup hardware_;
+    detail::EventGroup software_;
+};
+
+}  // namespace perf
+
+#endif /* __PERF_PERFCOUNTERS__ */
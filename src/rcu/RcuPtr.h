@@ -0,0 +1,139 @@
+#ifndef __RCU_RCUPTR__
+#define __RCU_RCUPTR__
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include <emmintrin.h>
+
+#include "ShardedCounter.h"
+
+// RCU 风格的指针：大的、读多写少的共享对象（路由表、配置表）。
+//
+//   读  auto r = ptr.read(); r->lookup(...)。读区间里拿到的版本不会被释放，也不会被修改
+//   写  ptr.update(std::make_unique<T>(...)) 发布新版本，等所有可能还在读旧版本的读者离开
+//       （宽限期）后释放旧版本；ptr.modify(f) 先拷一份当前版本、改完再发布
+//
+// 每个读线程按 ShardSlots 的槽位占一个独占缓存行的状态字：进入读区间时加一变成奇数，离开时再加一。
+// 读者只写自己的缓存行，读者之间不争任何东西；进入时的 seq_cst fence 是读路径上唯一的额外开销。
+// 写者换掉指针后扫一遍所有槽位：奇数的等到它变化为止（那个读区间结束了），偶数的不用管——
+// 它之后进入的读区间一定能看到新指针。
+//
+// 同一线程可以嵌套读同一个 RcuPtr。写者之间用互斥锁串行；update 会阻塞到宽限期结束，
+// 不能在读区间里调用（会等自己）。槽位超过 MAX_READERS 的线程改用一个共享的读者计数
+namespace rcu {
+
+template<typename T>
+class RcuPtr {
+    struct alignas(stats::CACHE_LINE) ReaderSlot {
+        std::atomic<uint64_t> state{0};  // 奇数表示在读区间里
+        unsigned depth = 0;              // 嵌套深度，只有占着槽位的线程访问
+    };
+
+public:
+    static constexpr unsigned MAX_READERS = 256;
+
+    class ReadGuard {
+    public:
+        ~ReadGuard() { owner_.exit(slot_); }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        const T* get() const { return p_; }
+        const T* operator->() const { return p_; }
+        const T& operator*() const { return *p_; }
+
+    private:
+        friend class RcuPtr;
+        ReadGuard(const RcuPtr& owner, unsigned slot) : owner_(owner), slot_(slot), p_(owner.enter(slot)) {}
+
+        const RcuPtr& owner_;
+        unsigned slot_;
+        const T* p_;
+    };
+
+    explicit RcuPtr(std::unique_ptr<T> init) : current_(init.release()), slots_(new ReaderSlot[MAX_READERS]) {}
+    ~RcuPtr() { delete current_.load(std::memory_order_relaxed); }
+
+    RcuPtr(const RcuPtr&) = delete;
+    RcuPtr& operator=(const RcuPtr&) = delete;
+
+    ReadGuard read() const { return ReadGuard(*this, ShardSlots::current()); }
+
+    void update(std::unique_ptr<T> next) {
+        std::lock_guard<std::mutex> lock(writer_mu_);
+        T* old = current_.exchange(next.release(), std::memory_order_seq_cst);
+        synchronize();
+        delete old;
+    }
+
+    // 拷贝当前版本，f 修改拷贝，再发布
+    template<typename F>
+    void modify(F&& f) {
+        std::lock_guard<std::mutex> lock(writer_mu_);
+        auto next = std::make_unique<T>(*current_.load(std::memory_order_relaxed));
+        f(*next);
+        T* old = current_.exchange(next.release(), std::memory_order_seq_cst);
+        synchronize();
+        delete old;
+    }
+
+    // 至今发布的版本数
+    uint64_t version() const { return version_.load(std::memory_order_relaxed); }
+
+private:
+    using ShardSlots = stats::ShardSlots;
+
+    const T* enter(unsigned slot) const {
+        if (slot < MAX_READERS) [[likely]] {
+            ReaderSlot& s = slots_[slot];
+            if (s.depth++ == 0) {
+                s.state.store(s.state.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                // 和写者换指针之后的 fence 配对：要么这里读到新指针，要么写者看到这个槽位是奇数
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        } else {
+            overflow_readers_.fetch_add(1, std::memory_order_seq_cst);
+        }
+        return current_.load(std::memory_order_acquire);
+    }
+
+    void exit(unsigned slot) const {
+        if (slot < MAX_READERS) [[likely]] {
+            ReaderSlot& s = slots_[slot];
+            if (--s.depth == 0) s.state.store(s.state.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        } else {
+            overflow_readers_.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    // 宽限期：换指针之前已经进入读区间的读者都离开
+    void synchronize() {
+        version_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const unsigned used = std::min(ShardSlots::high_water(), MAX_READERS);
+        for (unsigned i = 0; i < used; ++i) {
+            const uint64_t seen = slots_[i].state.load(std::memory_order_acquire);
+            if (!(seen & 1)) continue;
+            while (slots_[i].state.load(std::memory_order_acquire) == seen) {
+                _mm_pause();
+            }
+        }
+        while (overflow_readers_.load(std::memory_order_acquire) != 0) {
+            _mm_pause();
+        }
+    }
+
+    std::atomic<T*> current_;
+    const std::unique_ptr<ReaderSlot[]> slots_;
+    mutable std::atomic<uint64_t> overflow_readers_{0};
+    std::atomic<uint64_t> version_{0};
+    std::mutex writer_mu_;
+};
+
+}  // namespace rcu
+
+#endif /* __RCU_RCUPTR__ */
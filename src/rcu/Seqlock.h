@@ -0,0 +1,107 @@
+#ifndef __RCU_SEQLOCK__
+#define __RCU_SEQLOCK__
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include <emmintrin.h>
+
+// 顺序锁：小的、可平凡拷贝的快照（配置项、统计摘要、时钟校准参数……）。
+//
+// 读者不写任何共享内存：读版本号 -> 拷数据 -> 再读版本号，两次相同且为偶数就是一致的快照，
+// 否则重试。读者之间完全不争缓存行，只有写的那一刻才会让读者的缓存行失效。
+// 写者把版本号从偶数 CAS 成奇数（同时起到写者之间互斥的作用），写数据，再加一变回偶数。
+//
+// 数据按 8 字节一个 relaxed 原子量存放，读者和写者并发访问不是数据竞争；
+// 读者拷贝后的 acquire fence 保证"再读版本号"不会提前到拷贝之前（Boehm, "Can Seqlocks Get Along
+// with Programming Language Memory Models?"）。写得很频繁时读者可能一直重试，只适合读多写少
+namespace rcu {
+
+template<typename T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable_v<T>, "Seqlock needs a trivially copyable T");
+
+public:
+    Seqlock() : Seqlock(T{}) {}
+    explicit Seqlock(const T& init) { write_words(init); }
+
+    Seqlock(const Seqlock&) = delete;
+    Seqlock& operator=(const Seqlock&) = delete;
+
+    T load() const {
+        T out;
+        while (!try_load(out)) {
+            _mm_pause();
+        }
+        return out;
+    }
+
+    // 只试一次，和写者撞上时返回 false
+    bool try_load(T& out) const {
+        const uint64_t before = seq_.load(std::memory_order_acquire);
+        if (before & 1) return false;
+        uint64_t buf[WORDS];
+        for (size_t i = 0; i < WORDS; ++i) {
+            buf[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) != before) return false;
+        memcpy(&out, buf, sizeof(T));
+        return true;
+    }
+
+    void store(const T& value) {
+        const uint64_t seq = lock();
+        write_words(value);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    // 读-改-写：f 拿到当前值的拷贝并修改它，整个过程对别的写者互斥
+    template<typename F>
+    void update(F&& f) {
+        const uint64_t seq = lock();
+        T value;
+        uint64_t buf[WORDS];
+        for (size_t i = 0; i < WORDS; ++i) {
+            buf[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        memcpy(&value, buf, sizeof(T));
+        f(value);
+        write_words(value);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    // 至今完成的写次数
+    uint64_t version() const { return seq_.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + 7) / 8;
+
+    // 版本号从偶数改成奇数，返回改之前的值；release fence 让之后写数据的 store 不会排到它前面
+    uint64_t lock() {
+        uint64_t seq = seq_.load(std::memory_order_relaxed);
+        while (true) {
+            if (!(seq & 1) && seq_.compare_exchange_weak(seq, seq + 1, std::memory_order_relaxed)) break;
+            _mm_pause();
+            seq = seq_.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        return seq;
+    }
+
+    void write_words(const T& value) {
+        uint64_t buf[WORDS] = {};
+        memcpy(buf, &value, sizeof(T));
+        for (size_t i = 0; i < WORDS; ++i) {
+            words_[i].store(buf[i], std::memory_order_relaxed);
+        }
+    }
+
+    alignas(64) std::atomic<uint64_t> seq_{0};
+    std::atomic<uint64_t> words_[WORDS];
+};
+
+}  // namespace rcu
+
+#endif /* __RCU_SEQLOCK__ */
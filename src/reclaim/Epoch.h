@@ -0,0 +1,192 @@
+#ifndef __RECLAIM_EPOCH__
+#define __RECLAIM_EPOCH__
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "Retire.h"
+
+// 基于纪元的回收（EBR）：进入 Guard 时把当前全局纪元写进本线程的记录，退出时清零。
+// 退休的对象记下退休时的全局纪元 r；所有在临界区里的线程都追上当前纪元时全局纪元才能前进，
+// 纪元到了 r + 2，退休之前就在读的线程都已经离开，对象可以释放。
+//
+// 读路径只有进出临界区各一次写自己的缓存行（进入时一个 fence），protect 就是普通的 acquire load，
+// 比风险指针便宜；代价是未释放的对象数没有上界——一个线程停在临界区里，全局纪元就停住，
+// 所有线程退休的对象都只能攒着。
+//
+// Guard 可以嵌套。每个线程的退休链表按纪元有序，每 COLLECT_EVERY 次 retire 试着推进一次纪元，
+// 再从链表头释放够老的对象，只碰要释放的那些，retire 均摊是常数
+namespace reclaim {
+
+class Epoch {
+public:
+    static constexpr unsigned COLLECT_EVERY = 64;
+
+private:
+    struct alignas(stats::CACHE_LINE) Record {
+        std::atomic<uint64_t> epoch{0};  // 0 表示不在临界区，否则是进入时的全局纪元
+        std::atomic<bool> in_use{false};
+        Record* next = nullptr;
+    };
+
+    struct Local {
+        Record* record = nullptr;
+        unsigned depth = 0;
+        unsigned since_collect = 0;
+        std::deque<detail::Retired> retired;
+        std::vector<detail::Retired> adopted;  // 接手孤儿时的临时空间
+    };
+
+    struct State {
+        std::atomic<uint64_t> epoch{1};
+        detail::Registry<Record> records;
+        detail::Orphans orphans;
+        stats::ShardedGauge unreclaimed;
+    };
+
+public:
+    class Guard {
+    public:
+        Guard() : local_(local()) {
+            if (!local_) [[unlikely]] {
+                // 线程已经退出：临时借一条记录，不和别的 Guard 嵌套共用
+                record_ = state().records.acquire();
+                enter(record_);
+            } else if (local_->depth++ == 0) {
+                enter(local_->record);
+            }
+        }
+        ~Guard() {
+            if (!local_) [[unlikely]] {
+                record_->epoch.store(0, std::memory_order_release);
+                state().records.release(record_);
+            } else if (--local_->depth == 0) {
+                local_->record->epoch.store(0, std::memory_order_release);
+            }
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        // 和风险指针同一套接口；临界区里读到的对象都不会被释放，槽位号用不上
+        template<typename T>
+        T* protect(unsigned, const std::atomic<T*>& src) {
+            return src.load(std::memory_order_acquire);
+        }
+
+        void reset(unsigned) {}
+
+    private:
+        static void enter(Record* r) {
+            r->epoch.store(state().epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            // 公开自己的纪元之后才能读共享指针
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+
+        Local* local_;
+        Record* record_ = nullptr;
+    };
+
+    // p 必须已经从结构里摘下来，之后不会再有新的读者拿到它
+    template<typename T>
+    static void retire(T* p) {
+        retire(p, detail::delete_as<T>);
+    }
+
+    static void retire(void* p, void (*deleter)(void*)) {
+        Local* l = local();
+        State& s = state();
+        s.unreclaimed.inc();
+        if (!l) [[unlikely]] {
+            // 孤儿被接手时按那时的纪元重新记，不用在这里记
+            s.orphans.give({p, deleter, 0});
+            return;
+        }
+        l->retired.push_back({p, deleter, s.epoch.load(std::memory_order_acquire)});
+        if (++l->since_collect == COLLECT_EVERY) [[unlikely]] collect(*l);
+    }
+
+    // 尽量推进纪元，回收本线程（连同孤儿）可以释放的对象。别的线程都不在临界区时，在临界区外调用两次可以清空本线程的链表
+    static void collect() {
+        try_advance(state());
+        if (Local* l = local()) collect(*l);
+    }
+
+    static int64_t unreclaimed() { return state().unreclaimed.value(); }
+
+    static uint64_t epoch() { return state().epoch.load(std::memory_order_relaxed); }
+
+private:
+    static State& state() {
+        static State* s = new State;
+        return *s;
+    }
+
+    static inline constinit thread_local Local* tls_ = nullptr;
+    static inline constinit thread_local bool tls_exited_ = false;
+
+    // Holder 已经析构（线程在析构别的 thread_local）时返回 nullptr
+    static Local* local() {
+        Local* l = tls_;
+        if (!l) [[unlikely]] l = attach();
+        return l;
+    }
+
+    // 线程退出时 Holder 析构：最后回收一次，剩下的交给孤儿链表，记录还回去。
+    // 之后不再挂新的：thread_local 的 holder 已经死了，记录也可能被别的线程拿走
+    [[gnu::noinline]] static Local* attach() {
+        if (tls_exited_) return nullptr;
+        struct Holder {
+            Local local;
+            Holder() { local.record = state().records.acquire(); }
+            ~Holder() {
+                collect(local);
+                local.adopted.assign(local.retired.begin(), local.retired.end());
+                state().orphans.give(local.adopted);
+                state().records.release(local.record);
+                tls_ = nullptr;
+                tls_exited_ = true;
+            }
+        };
+        thread_local Holder holder;
+        return tls_ = &holder.local;
+    }
+
+    // 在临界区里的线程都已经在当前纪元上时推进一格
+    static void try_advance(State& s) {
+        uint64_t e = s.epoch.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        bool behind = false;
+        s.records.for_each([&](const Record& r) {
+            const uint64_t x = r.epoch.load(std::memory_order_relaxed);
+            behind |= x != 0 && x != e;
+        });
+        if (!behind) s.epoch.compare_exchange_strong(e, e + 1, std::memory_order_acq_rel, std::memory_order_relaxed);
+    }
+
+    [[gnu::noinline]] static void collect(Local& l) {
+        State& s = state();
+        l.since_collect = 0;
+        // 孤儿按现在的纪元重新记，保持链表有序；只会晚一点释放
+        s.orphans.adopt(l.adopted);
+        for (auto& r : l.adopted) {
+            l.retired.push_back({r.p, r.deleter, s.epoch.load(std::memory_order_acquire)});
+        }
+        l.adopted.clear();
+        try_advance(s);
+        const uint64_t e = s.epoch.load(std::memory_order_acquire);
+        int64_t freed = 0;
+        while (!l.retired.empty() && l.retired.front().epoch + 2 <= e) {
+            l.retired.front().deleter(l.retired.front().p);
+            l.retired.pop_front();
+            ++freed;
+        }
+        s.unreclaimed.add(-freed);
+    }
+};
+
+}  // namespace reclaim
+
+#endif /* __RECLAIM_EPOCH__ */
@@ -0,0 +1,171 @@
+#ifndef __RECLAIM_HAZARDPOINTERS__
+#define __RECLAIM_HAZARDPOINTERS__
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "Retire.h"
+
+// 风险指针：每个线程有 SLOTS 个公开的槽位，读共享指针前先把它写进槽位（protect），
+// 再确认源头没变，之后这个对象就不会被释放。释放方扫描所有线程的槽位，只释放没人登记的对象。
+//
+// 未释放的对象数有上界：每个线程的退休链表攒到 max(MIN_SCAN, 2 × 全部槽位数) 才扫描一次，
+// 一次扫描至少释放一半，所以 retire 均摊是常数，卡住的读者也只能扣住它登记的那几个对象。
+// 代价在读路径上：每次 protect 是一次 seq_cst store（x86 上是 xchg）加一次重读。
+//
+// 同一线程同一时刻只能有一个 Guard，析构时清空全部槽位
+namespace reclaim {
+
+class HazardPointers {
+public:
+    static constexpr unsigned SLOTS = 4;
+    static constexpr size_t MIN_SCAN = 64;
+
+private:
+    struct alignas(stats::CACHE_LINE) Record {
+        std::atomic<void*> slots[SLOTS] = {};
+        std::atomic<bool> in_use{false};
+        Record* next = nullptr;
+    };
+
+    struct Local {
+        Record* record = nullptr;
+        std::vector<detail::Retired> retired;
+        std::vector<void*> hazards;  // 扫描时的临时空间，留着复用
+    };
+
+    struct State {
+        detail::Registry<Record> records;
+        detail::Orphans orphans;
+        stats::ShardedGauge unreclaimed;
+    };
+
+public:
+    class Guard {
+    public:
+        Guard() {
+            Local* l = local();
+            record_ = l ? l->record : state().records.acquire();
+            borrowed_ = !l;
+        }
+        ~Guard() {
+            for (auto& slot : record_->slots) {
+                slot.store(nullptr, std::memory_order_release);
+            }
+            if (borrowed_) [[unlikely]] state().records.release(record_);
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        // 读 src 并登记在第 i 个槽位上，直到 reset(i)、下一次 protect(i) 或 Guard 析构
+        template<typename T>
+        T* protect(unsigned i, const std::atomic<T*>& src) {
+            T* p = src.load(std::memory_order_relaxed);
+            for (;;) {
+                record_->slots[i].store(p, std::memory_order_seq_cst);
+                T* q = src.load(std::memory_order_acquire);
+                if (q == p) return p;
+                p = q;
+            }
+        }
+
+        void reset(unsigned i) { record_->slots[i].store(nullptr, std::memory_order_release); }
+
+    private:
+        Record* record_;
+        bool borrowed_;  // 线程已经退出，记录是临时借的
+    };
+
+    // p 必须已经从结构里摘下来，之后不会再有新的读者拿到它
+    template<typename T>
+    static void retire(T* p) {
+        retire(p, detail::delete_as<T>);
+    }
+
+    static void retire(void* p, void (*deleter)(void*)) {
+        Local* l = local();
+        State& s = state();
+        s.unreclaimed.inc();
+        if (!l) [[unlikely]] {
+            s.orphans.give({p, deleter, 0});
+            return;
+        }
+        l->retired.push_back({p, deleter, 0});
+        if (l->retired.size() >= std::max<size_t>(MIN_SCAN, 2 * SLOTS * s.records.count())) [[unlikely]] {
+            scan(*l);
+        }
+    }
+
+    // 马上扫描一次本线程的退休链表（连同孤儿）
+    static void collect() {
+        if (Local* l = local()) scan(*l);
+    }
+
+    static int64_t unreclaimed() { return state().unreclaimed.value(); }
+
+private:
+    static State& state() {
+        static State* s = new State;
+        return *s;
+    }
+
+    static inline constinit thread_local Local* tls_ = nullptr;
+    static inline constinit thread_local bool tls_exited_ = false;
+
+    // Holder 已经析构（线程在析构别的 thread_local）时返回 nullptr
+    static Local* local() {
+        Local* l = tls_;
+        if (!l) [[unlikely]] l = attach();
+        return l;
+    }
+
+    // 线程退出时 Holder 析构：最后扫一次，剩下的交给孤儿链表，记录还回去。
+    // 之后不再挂新的：thread_local 的 holder 已经死了，记录也可能被别的线程拿走
+    [[gnu::noinline]] static Local* attach() {
+        if (tls_exited_) return nullptr;
+        struct Holder {
+            Local local;
+            Holder() { local.record = state().records.acquire(); }
+            ~Holder() {
+                scan(local);
+                state().orphans.give(local.retired);
+                state().records.release(local.record);
+                tls_ = nullptr;
+                tls_exited_ = true;
+            }
+        };
+        thread_local Holder holder;
+        return tls_ = &holder.local;
+    }
+
+    [[gnu::noinline]] static void scan(Local& l) {
+        State& s = state();
+        s.orphans.adopt(l.retired);
+        // 和 protect 里的 seq_cst store 配对：摘下对象在前、读槽位在后，读者要么被看到，要么重读时发现源头变了
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        l.hazards.clear();
+        s.records.for_each([&](const Record& r) {
+            for (const auto& slot : r.slots) {
+                if (void* p = slot.load(std::memory_order_acquire)) l.hazards.push_back(p);
+            }
+        });
+        std::sort(l.hazards.begin(), l.hazards.end());
+
+        auto keep = l.retired.begin();
+        for (auto& r : l.retired) {
+            if (std::binary_search(l.hazards.begin(), l.hazards.end(), r.p)) {
+                *keep++ = r;
+            } else {
+                r.deleter(r.p);
+            }
+        }
+        s.unreclaimed.add(-int64_t(l.retired.end() - keep));
+        l.retired.erase(keep, l.retired.end());
+    }
+};
+
+}  // namespace reclaim
+
+#endif /* __RECLAIM_HAZARDPOINTERS__ */
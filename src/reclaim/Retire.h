@@ -0,0 +1,105 @@
+#ifndef __RECLAIM_RETIRE__
+#define __RECLAIM_RETIRE__
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "ShardedCounter.h"
+
+// 无锁结构的安全内存回收，两种方案对外是同一套接口（Scheme 取 HazardPointers 或 Epoch）：
+//
+//   typename Scheme::Guard guard;          // 读临界区，析构时结束
+//   Node* p = guard.protect(0, head_);     // 读一个共享指针，guard 活着期间 p 不会被释放
+//   Scheme::retire(p);                     // p 已经从结构里摘下来，等没人能再读到它时 delete
+//
+// 每个线程有自己的退休链表，攒够一批才扫描一次（均摊到每次 retire 是常数）。
+// 线程退出时还没能释放的对象交给孤儿链表，由之后任意线程的扫描接手；线程的 thread_local 析构完之后
+// 再 retire 的对象也直接进孤儿链表，这时的 Guard 临时借一条记录，析构时还回去。
+// Scheme::unreclaimed() 是已退休、还没释放的对象数，Scheme::collect() 马上回收一次本线程的链表
+namespace reclaim {
+
+namespace detail {
+
+struct Retired {
+    void* p;
+    void (*deleter)(void*);
+    uint64_t epoch;  // 只有 Epoch 用：退休时的全局纪元
+};
+
+template<typename T>
+void delete_as(void* p) {
+    delete static_cast<T*>(p);
+}
+
+// 每个线程占一条记录，线程退出时放回去给后来的线程复用；记录只增不减，扫描的一方无锁遍历
+template<typename Record>
+class Registry {
+public:
+    Record* acquire() {
+        for (Record* r = head_.load(std::memory_order_acquire); r; r = r->next) {
+            if (!r->in_use.load(std::memory_order_relaxed) && !r->in_use.exchange(true, std::memory_order_acquire)) {
+                return r;
+            }
+        }
+        auto* r = new Record;
+        r->in_use.store(true, std::memory_order_relaxed);
+        r->next = head_.load(std::memory_order_relaxed);
+        while (!head_.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+        count_.fetch_add(1, std::memory_order_relaxed);
+        return r;
+    }
+
+    void release(Record* r) { r->in_use.store(false, std::memory_order_release); }
+
+    template<typename F>
+    void for_each(F&& f) const {
+        for (Record* r = head_.load(std::memory_order_acquire); r; r = r->next) {
+            f(*r);
+        }
+    }
+
+    unsigned count() const { return count_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<Record*> head_{nullptr};
+    std::atomic<unsigned> count_{0};
+};
+
+// 退出线程留下的退休对象
+class Orphans {
+public:
+    void give(const Retired& r) {
+        std::lock_guard<std::mutex> lock(mu_);
+        list_.push_back(r);
+        pending_.store(true, std::memory_order_release);
+    }
+
+    void give(std::vector<Retired>& list) {
+        if (list.empty()) return;
+        std::lock_guard<std::mutex> lock(mu_);
+        list_.insert(list_.end(), list.begin(), list.end());
+        list.clear();
+        pending_.store(true, std::memory_order_release);
+    }
+
+    void adopt(std::vector<Retired>& into) {
+        if (!pending_.load(std::memory_order_acquire)) return;
+        std::lock_guard<std::mutex> lock(mu_);
+        into.insert(into.end(), list_.begin(), list_.end());
+        list_.clear();
+        pending_.store(false, std::memory_order_relaxed);
+    }
+
+private:
+    std::mutex mu_;
+    std::vector<Retired> list_;
+    std::atomic<bool> pending_{false};
+};
+
+}  // namespace detail
+
+}  // namespace reclaim
+
+#endif /* __RECLAIM_RETIRE__ */
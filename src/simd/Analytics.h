@@ -0,0 +1,45 @@
+#ifndef __SIMD_ANALYTICS__
+#define __SIMD_ANALYTICS__
+#include <cstddef>
+#include <cstdint>
+
+#include "Reduce.h"
+
+// 列式分析里常用的 int32 内核：min/max、argmax、前缀和、按谓词过滤并压紧、小桶直方图。
+// 和求和一样按 CPU 分派，目前有标量和 AVX2 两套，AVX-512 机器上用 AVX2 那套
+namespace simd {
+
+struct MinMax {
+    int32_t min;
+    int32_t max;
+};
+
+// 直方图最多的桶数
+constexpr unsigned MAX_HISTOGRAM_BINS = 256;
+
+struct AnalyticsKernels {
+    // 要求 n > 0
+    MinMax (*minmax)(const int32_t* p, size_t n);
+    // 第一个最大值的下标，n == 0 时返回 0
+    size_t (*argmax)(const int32_t* p, size_t n);
+    // out[i] = in[0] + ... + in[i]，按 2^32 回绕；out 可以就是 in
+    void (*inclusive_scan)(const int32_t* in, int32_t* out, size_t n);
+    // 把 in 中 > threshold 的元素按原顺序写到 out，返回个数；out 至少要有 n 个元素的空间
+    size_t (*filter_gt)(const int32_t* in, size_t n, int32_t threshold, int32_t* out);
+    // bin = min((max(v, lo) - lo) >> shift, bins - 1)，结果覆盖 counts[0, bins)；bins <= MAX_HISTOGRAM_BINS
+    void (*histogram)(const int32_t* p, size_t n, int32_t lo, unsigned shift, uint32_t* counts, unsigned bins);
+};
+
+// 只有 Scalar 和 AVX2 两档；该档没编译进来或 CPU 不支持时返回 nullptr
+const AnalyticsKernels* analytics_kernels(Isa isa);
+
+// 按 active_isa() 选中的内核
+MinMax minmax(const int32_t* p, size_t n);
+size_t argmax(const int32_t* p, size_t n);
+void inclusive_scan(const int32_t* in, int32_t* out, size_t n);
+size_t filter_gt(const int32_t* in, size_t n, int32_t threshold, int32_t* out);
+void histogram(const int32_t* p, size_t n, int32_t lo, unsigned shift, uint32_t* counts, unsigned bins);
+
+}  // namespace simd
+
+#endif /* __SIMD_ANALYTICS__ */
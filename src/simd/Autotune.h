@@ -0,0 +1,41 @@
+#ifndef __SIMD_AUTOTUNE__
+#define __SIMD_AUTOTUNE__
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "Reduce.h"
+
+// 求和内核的启动期自动调优。
+//
+// 最佳的累加器数 / 展开数取决于 CPU 的加法延迟、load 端口数，以及数据在哪一级缓存。
+// 每种元素类型 × 每个尺寸档第一次用到时，把 sum_variants(active_isa()) 里的候选逐个跑一遍，
+// 选最快的缓存下来，并追加到磁盘上的 profile 文件；之后同一型号 CPU 上的进程直接读 profile，不再测。
+//
+// profile 路径：环境变量 SIMD_PROFILE，未设置时为 $HOME/.cache/hpp_simd_profile；
+// SIMD_PROFILE 设为空串时不读也不写。每行一条：<cpu> <isa> <type> <size class> <acc> <unroll>，后出现的覆盖前面的
+namespace simd {
+
+enum class ElemType { I32 = 0, I64 = 1, F32 = 2, F64 = 3 };
+
+// 按数据总字节数分档：L1 <= 32K，L2 <= 1M，LLC <= 32M，更大为 DRAM
+enum class SizeClass { L1 = 0, L2 = 1, LLC = 2, DRAM = 3 };
+
+const char* elem_type_name(ElemType type);
+const char* size_class_name(SizeClass cls);
+SizeClass size_class(size_t bytes);
+
+// 调优结果；第一次调用时可能要花几百毫秒测量（DRAM 档最慢），线程安全
+const SumVariant& tuned_variant(ElemType type, SizeClass cls);
+
+std::string profile_path();
+
+// 按数据大小选调好的内核
+int64_t tuned_sum(const int32_t* p, size_t n);
+int64_t tuned_sum(const int64_t* p, size_t n);
+double tuned_sum(const float* p, size_t n);
+double tuned_sum(const double* p, size_t n);
+
+}  // namespace simd
+
+#endif /* __SIMD_AUTOTUNE__ */
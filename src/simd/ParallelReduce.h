@@ -0,0 +1,98 @@
+#ifndef __SIMD_PARALLELREDUCE__
+#define __SIMD_PARALLELREDUCE__
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "Reduce.h"
+
+// 多核并行求和。
+//
+// 数组按线程数静态切成连续的几段，段边界对齐到页，每个线程只碰自己那一段：
+// 用 parallel_fill 初始化时由各线程自己首次写入，页就分配在该线程所在的 NUMA 节点上，
+// 之后 parallel_sum 用同样的切分去读，访问都是本地内存。段内再按 CHUNK_BYTES 分块
+// 调用 SIMD 内核，每个线程的部分和写在独占缓存行的槽里，最后由调用者合并。
+namespace simd {
+
+// 一组常驻、绑核的工作线程。run() 让每个线程执行一次 fn(index)，调用者阻塞到全部完成。
+// 同一时刻只允许一个线程调用 run()
+class ThreadTeam {
+public:
+    // threads == 0 时取进程允许的 CPU 数。按 --pin 策略绑核；没指定策略时第 i 个线程绑到进程允许的第 i % N 个 CPU
+    explicit ThreadTeam(unsigned threads = 0);
+    ~ThreadTeam();
+
+    ThreadTeam(const ThreadTeam&) = delete;
+    ThreadTeam& operator=(const ThreadTeam&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+
+    void run(const std::function<void(unsigned)>& fn);
+
+private:
+    void worker_loop(unsigned index);
+
+    std::vector<std::thread> workers_;
+    const std::function<void(unsigned)>* job_ = nullptr;
+    alignas(64) std::atomic<uint64_t> generation_{0};
+    alignas(64) std::atomic<unsigned> pending_{0};
+    bool stopping_ = false;
+};
+
+// 每个线程处理的段内分块大小，约等于 L2 的一部分
+constexpr size_t CHUNK_BYTES = 256 * 1024;
+constexpr size_t PAGE_BYTES = 4096;
+
+// 第 index 个线程负责的 [begin, end)，边界按页对齐（元素大小整除页大小时）
+template<typename T>
+inline void thread_range(size_t n, unsigned index, unsigned threads, size_t& begin, size_t& end) {
+    constexpr size_t per_page = PAGE_BYTES % sizeof(T) == 0 ? PAGE_BYTES / sizeof(T) : 1;
+    size_t pages = (n + per_page - 1) / per_page;
+    begin = std::min(n, pages * index / threads * per_page);
+    end = std::min(n, pages * (index + 1) / threads * per_page);
+}
+
+// 用 gen(i) 填充 p[0, n)，切分方式与 parallel_sum 相同
+template<typename T, typename Gen>
+void parallel_fill(ThreadTeam& team, T* p, size_t n, Gen gen) {
+    team.run([&](unsigned index) {
+        size_t begin, end;
+        thread_range<T>(n, index, team.size(), begin, end);
+        for (size_t i = begin; i < end; ++i) {
+            p[i] = gen(i);
+        }
+    });
+}
+
+// 返回类型与 simd::sum 相同：int32 / int64 → int64，float / double → double
+template<typename T>
+auto parallel_sum(ThreadTeam& team, const T* p, size_t n) {
+    using Result = decltype(sum(p, n));
+    struct alignas(64) Slot {
+        Result value;
+    };
+    std::vector<Slot> partial(team.size());
+    team.run([&](unsigned index) {
+        size_t begin, end;
+        thread_range<T>(n, index, team.size(), begin, end);
+        constexpr size_t chunk = CHUNK_BYTES / sizeof(T);
+        Result acc = 0;
+        for (size_t i = begin; i < end; i += chunk) {
+            acc += sum(p + i, std::min(chunk, end - i));
+        }
+        partial[index].value = acc;
+    });
+    Result total = 0;
+    for (const Slot& s : partial) {
+        total += s.value;
+    }
+    return total;
+}
+
+}  // namespace simd
+
+#endif /* __SIMD_PARALLELREDUCE__ */
@@ -0,0 +1,52 @@
+#ifndef __SIMD_REDUCE__
+#define __SIMD_REDUCE__
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// 运行时按 CPU 分派的求和库。
+//
+// 每个 ISA 一个翻译单元、单独加编译选项（见 CMakeLists.txt），主程序本身不需要
+// -march=native，同一个二进制可以跑在不同代的机器上。累加器一律加宽：
+// int32 → int64，float → double，避免长数组溢出或丢精度。
+namespace simd {
+
+enum class Isa { Scalar = 0, SSE42 = 1, AVX2 = 2, AVX512 = 3 };
+
+const char* isa_name(Isa isa);
+
+// CPU 支持且本库编译了对应内核的最高等级
+Isa detect_isa();
+
+// 实际使用的等级：detect_isa()，可用环境变量 SIMD_ISA=scalar|sse4.2|avx2|avx512 往下限制
+Isa active_isa();
+
+struct SumKernels {
+    int64_t (*i32)(const int32_t* p, size_t n);
+    int64_t (*i64)(const int64_t* p, size_t n);
+    double (*f32)(const float* p, size_t n);
+    double (*f64)(const double* p, size_t n);
+};
+
+// 指定等级的内核表；该等级没编译进来或 CPU 不支持时返回 nullptr
+const SumKernels* sum_kernels(Isa isa);
+
+// 同一 ISA 下按 (累加器数, 每轮展开的向量数) 编译出的一组候选内核，供调优和基准测试
+struct SumVariant {
+    unsigned acc;
+    unsigned unroll;
+    SumKernels kernels;
+};
+
+// 该等级不可用时返回空
+std::span<const SumVariant> sum_variants(Isa isa);
+
+// 使用 active_isa() 的内核（首次调用时解析，之后只是一次间接调用）
+int64_t sum(const int32_t* p, size_t n);
+int64_t sum(const int64_t* p, size_t n);
+double sum(const float* p, size_t n);
+double sum(const double* p, size_t n);
+
+}  // namespace simd
+
+#endif /* __SIMD_REDUCE__ */
@@ -0,0 +1,116 @@
+#ifndef __SIMD_REDUCEKERNELS__
+#define __SIMD_REDUCEKERNELS__
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "Reduce.h"
+
+// 各 ISA 翻译单元导出的内核表，只在库内部使用
+namespace simd {
+
+// 编译期实例化的 (累加器数, 每轮展开的向量数) 组合；展开数是累加器数的整数倍
+struct GridPoint {
+    unsigned acc;
+    unsigned unroll;
+};
+
+constexpr GridPoint SUM_GRID[] = {
+    {1, 1}, {1, 4}, {2, 2}, {2, 4}, {2, 8}, {4, 4}, {4, 8}, {4, 16}, {6, 6}, {6, 12}, {8, 8}, {8, 16},
+};
+constexpr size_t SUM_GRID_SIZE = std::size(SUM_GRID);
+
+using SumGrid = std::array<SumVariant, SUM_GRID_SIZE>;
+
+// 默认内核表用 4 个累加器、每轮 4 个向量
+extern const SumKernels sum_kernels_scalar;
+extern const SumGrid sum_grid_scalar;
+#ifdef SIMD_HAVE_SSE42
+extern const SumKernels sum_kernels_sse42;
+extern const SumGrid sum_grid_sse42;
+#endif
+#ifdef SIMD_HAVE_AVX2
+extern const SumKernels sum_kernels_avx2;
+extern const SumGrid sum_grid_avx2;
+#endif
+#ifdef SIMD_HAVE_AVX512
+extern const SumKernels sum_kernels_avx512;
+extern const SumGrid sum_grid_avx512;
+#endif
+
+// 下面的模板会被不同编译选项的翻译单元各自实例化，必须放在匿名命名空间里：
+// 否则链接器可能把 -mavx512f 编出来的同名实例挑给标量路径用，在老 CPU 上 SIGILL
+namespace {
+
+// 标量处理到 p 按 Align 字节对齐为止，返回处理掉的元素个数
+template<size_t Align, typename Acc, typename T>
+inline size_t peel_head(const T* p, size_t n, Acc& acc) {
+    size_t head = 0;
+    while (head < n && (reinterpret_cast<uintptr_t>(p + head) & (Align - 1)) != 0) {
+        acc += p[head++];
+    }
+    return head;
+}
+
+// 通用的多累加器向量求和。Ops 描述一种 ISA + 元素类型：
+//   T / Result    元素类型 / 加宽后的结果类型
+//   Vec           加宽后的累加向量
+//   WIDTH         每次 load 处理的元素个数，ALIGN 为其字节数
+//   zero/load/add/hsum
+// 每轮 UNROLL 次 load，第 u 次加到 acc[u % ACC] 上。累加器数决定能同时在飞的加法链条数
+// （要盖住加法延迟 × 每周期可发射的加法数），展开数决定每轮循环开销摊到多少次 load 上。
+// 对齐前的头部和不足一轮的尾部走标量
+template<typename Ops, unsigned ACC = 4, unsigned UNROLL = 4>
+typename Ops::Result sum_loop(const typename Ops::T* p, size_t n) {
+    static_assert(ACC > 0 && UNROLL % ACC == 0, "UNROLL must be a multiple of ACC");
+    using Vec = typename Ops::Vec;
+    constexpr size_t W = Ops::WIDTH;
+
+    typename Ops::Result total = 0;
+    size_t i = peel_head<Ops::ALIGN>(p, n, total);
+
+    Vec acc[ACC];
+    for (auto& a : acc) {
+        a = Ops::zero();
+    }
+    for (; i + UNROLL * W <= n; i += UNROLL * W) {
+        [&]<unsigned... U>(std::integer_sequence<unsigned, U...>) {
+            ((acc[U % ACC] = Ops::add(acc[U % ACC], Ops::load(p + i + U * W))), ...);
+        }(std::make_integer_sequence<unsigned, UNROLL>{});
+    }
+    // 两两合并，保持加法树的深度为 log(ACC)
+    for (unsigned stride = 1; stride < ACC; stride *= 2) {
+        for (unsigned a = 0; a + stride < ACC; a += 2 * stride) {
+            acc[a] = Ops::add(acc[a], acc[a + stride]);
+        }
+    }
+    total += Ops::hsum(acc[0]);
+
+    for (; i < n; ++i) {
+        total += p[i];
+    }
+    return total;
+}
+
+// 给定四种元素类型的 Ops，实例化整张 SUM_GRID
+template<typename I32, typename I64, typename F32, typename F64, size_t... I>
+constexpr SumGrid make_sum_grid(std::index_sequence<I...>) {
+    return {SumVariant{SUM_GRID[I].acc,
+                       SUM_GRID[I].unroll,
+                       {sum_loop<I32, SUM_GRID[I].acc, SUM_GRID[I].unroll>,
+                        sum_loop<I64, SUM_GRID[I].acc, SUM_GRID[I].unroll>,
+                        sum_loop<F32, SUM_GRID[I].acc, SUM_GRID[I].unroll>,
+                        sum_loop<F64, SUM_GRID[I].acc, SUM_GRID[I].unroll>}}...};
+}
+
+template<typename I32, typename I64, typename F32, typename F64>
+constexpr SumGrid make_sum_grid() {
+    return make_sum_grid<I32, I64, F32, F64>(std::make_index_sequence<SUM_GRID_SIZE>{});
+}
+
+}  // namespace
+
+}  // namespace simd
+
+#endif /* __SIMD_REDUCEKERNELS__ */
@@ -0,0 +1,104 @@
+#include <algorithm>
+
+#include "Analytics.h"
+
+namespace simd {
+
+#ifdef SIMD_HAVE_AVX2
+extern const AnalyticsKernels analytics_kernels_avx2;
+#endif
+
+namespace {
+
+MinMax minmax_scalar(const int32_t* p, size_t n) {
+    MinMax r{p[0], p[0]};
+    for (size_t i = 1; i < n; ++i) {
+        r.min = std::min(r.min, p[i]);
+        r.max = std::max(r.max, p[i]);
+    }
+    return r;
+}
+
+size_t argmax_scalar(const int32_t* p, size_t n) {
+    size_t best = 0;
+    for (size_t i = 1; i < n; ++i) {
+        if (p[i] > p[best]) best = i;
+    }
+    return best;
+}
+
+void inclusive_scan_scalar(const int32_t* in, int32_t* out, size_t n) {
+    uint32_t acc = 0;
+    for (size_t i = 0; i < n; ++i) {
+        acc += static_cast<uint32_t>(in[i]);
+        out[i] = static_cast<int32_t>(acc);
+    }
+}
+
+// 无分支写法：总是写，按条件推进下标
+size_t filter_gt_scalar(const int32_t* in, size_t n, int32_t threshold, int32_t* out) {
+    size_t k = 0;
+    for (size_t i = 0; i < n; ++i) {
+        out[k] = in[i];
+        k += in[i] > threshold;
+    }
+    return k;
+}
+
+// 4 份子直方图轮流加，避免相邻元素落在同一个桶时的 store → load 依赖
+void histogram_scalar(const int32_t* p, size_t n, int32_t lo, unsigned shift, uint32_t* counts, unsigned bins) {
+    uint32_t sub[4][MAX_HISTOGRAM_BINS] = {};
+    size_t i = 0;
+    auto bin_of = [&](int32_t v) {
+        uint32_t d = static_cast<uint32_t>(std::max(v, lo)) - static_cast<uint32_t>(lo);
+        return std::min<uint32_t>(d >> shift, bins - 1);
+    };
+    for (; i + 4 <= n; i += 4) {
+        ++sub[0][bin_of(p[i + 0])];
+        ++sub[1][bin_of(p[i + 1])];
+        ++sub[2][bin_of(p[i + 2])];
+        ++sub[3][bin_of(p[i + 3])];
+    }
+    for (; i < n; ++i) {
+        ++sub[0][bin_of(p[i])];
+    }
+    for (unsigned b = 0; b < bins; ++b) {
+        counts[b] = sub[0][b] + sub[1][b] + sub[2][b] + sub[3][b];
+    }
+}
+
+const AnalyticsKernels analytics_kernels_scalar = {
+    minmax_scalar, argmax_scalar, inclusive_scan_scalar, filter_gt_scalar, histogram_scalar,
+};
+
+const AnalyticsKernels& active_analytics() {
+    static const AnalyticsKernels* k = [] {
+        const AnalyticsKernels* avx2 = active_isa() >= Isa::AVX2 ? analytics_kernels(Isa::AVX2) : nullptr;
+        return avx2 ? avx2 : &analytics_kernels_scalar;
+    }();
+    return *k;
+}
+
+}  // namespace
+
+const AnalyticsKernels* analytics_kernels(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar: return &analytics_kernels_scalar;
+#ifdef SIMD_HAVE_AVX2
+        case Isa::AVX2: return sum_kernels(Isa::AVX2) ? &analytics_kernels_avx2 : nullptr;
+#endif
+        default: return nullptr;
+    }
+}
+
+MinMax minmax(const int32_t* p, size_t n) { return active_analytics().minmax(p, n); }
+size_t argmax(const int32_t* p, size_t n) { return active_analytics().argmax(p, n); }
+void inclusive_scan(const int32_t* in, int32_t* out, size_t n) { active_analytics().inclusive_scan(in, out, n); }
+size_t filter_gt(const int32_t* in, size_t n, int32_t threshold, int32_t* out) {
+    return active_analytics().filter_gt(in, n, threshold, out);
+}
+void histogram(const int32_t* p, size_t n, int32_t lo, unsigned shift, uint32_t* counts, unsigned bins) {
+    active_analytics().histogram(p, n, lo, shift, counts, bins);
+}
+
+}  // namespace simd
@@ -0,0 +1,164 @@
+#include <immintrin.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+#include "Analytics.h"
+
+// 本文件以 -mavx2 编译
+namespace simd {
+
+extern const AnalyticsKernels analytics_kernels_avx2;
+
+namespace {
+
+inline __m256i load8(const int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+inline void store8(int32_t* p, __m256i v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+
+int32_t hmin(__m256i v) {
+    __m128i m = _mm_min_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+    m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(m);
+}
+
+int32_t hmax(__m256i v) {
+    __m128i m = _mm_max_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    m = _mm_max_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+    m = _mm_max_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(m);
+}
+
+// 4 组独立的 min / max 累加器，和 sum_loop 一样打断依赖链
+MinMax minmax_avx2(const int32_t* p, size_t n) {
+    MinMax r{p[0], p[0]};
+    size_t i = 0;
+    if (n >= 32) {
+        __m256i lo[4], hi[4];
+        for (int k = 0; k < 4; ++k) {
+            lo[k] = hi[k] = load8(p + 8 * k);
+        }
+        for (i = 32; i + 32 <= n; i += 32) {
+            for (int k = 0; k < 4; ++k) {
+                __m256i v = load8(p + i + 8 * k);
+                lo[k] = _mm256_min_epi32(lo[k], v);
+                hi[k] = _mm256_max_epi32(hi[k], v);
+            }
+        }
+        r.min = hmin(_mm256_min_epi32(_mm256_min_epi32(lo[0], lo[1]), _mm256_min_epi32(lo[2], lo[3])));
+        r.max = hmax(_mm256_max_epi32(_mm256_max_epi32(hi[0], hi[1]), _mm256_max_epi32(hi[2], hi[3])));
+    }
+    for (; i < n; ++i) {
+        r.min = std::min(r.min, p[i]);
+        r.max = std::max(r.max, p[i]);
+    }
+    return r;
+}
+
+// 先求最大值，再从头用 cmpeq + movemask 找第一个等于它的位置。
+// 比逐元素跟踪下标（每步一次 blend，下标还受 32 位限制）快，第二遍通常很早就停
+size_t argmax_avx2(const int32_t* p, size_t n) {
+    if (n == 0) return 0;
+    const int32_t m = minmax_avx2(p, n).max;
+    const __m256i target = _mm256_set1_epi32(m);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(load8(p + i), target)));
+        if (mask) return i + std::countr_zero(mask);
+    }
+    for (; i < n; ++i) {
+        if (p[i] == m) return i;
+    }
+    return 0;
+}
+
+// 每 8 个元素：128 位半边内做 log 步移位相加，再把低半边的和加到高半边，最后加上之前的进位
+void inclusive_scan_avx2(const int32_t* in, int32_t* out, size_t n) {
+    __m256i carry = _mm256_setzero_si256();
+    const __m256i last = _mm256_set1_epi32(7);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = load8(in + i);
+        x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+        x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+        __m256i low_total = _mm256_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));
+        x = _mm256_add_epi32(x, _mm256_permute2x128_si256(low_total, low_total, 0x08));
+        x = _mm256_add_epi32(x, carry);
+        store8(out + i, x);
+        carry = _mm256_permutevar8x32_epi32(x, last);
+    }
+    uint32_t acc = static_cast<uint32_t>(_mm256_cvtsi256_si32(carry));
+    for (; i < n; ++i) {
+        acc += static_cast<uint32_t>(in[i]);
+        out[i] = static_cast<int32_t>(acc);
+    }
+}
+
+// movemask 的 8 位结果 → 把选中的 lane 挪到前面的 vpermd 下标
+constexpr auto COMPRESS_LUT = [] {
+    std::array<std::array<int32_t, 8>, 256> lut{};
+    for (unsigned mask = 0; mask < 256; ++mask) {
+        int k = 0;
+        for (int lane = 0; lane < 8; ++lane) {
+            if (mask & (1u << lane)) lut[mask][k++] = lane;
+        }
+    }
+    return lut;
+}();
+
+// 每次整块写 8 个元素，只推进选中的个数；因为 k <= i，写出不会越过 out + n
+size_t filter_gt_avx2(const int32_t* in, size_t n, int32_t threshold, int32_t* out) {
+    const __m256i t = _mm256_set1_epi32(threshold);
+    size_t i = 0, k = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = load8(in + i);
+        unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, t)));
+        __m256i perm = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(COMPRESS_LUT[mask].data()));
+        store8(out + k, _mm256_permutevar8x32_epi32(v, perm));
+        k += std::popcount(mask);
+    }
+    for (; i < n; ++i) {
+        out[k] = in[i];
+        k += in[i] > threshold;
+    }
+    return k;
+}
+
+// 桶号一次算 8 个，计数仍是标量自增，分到 4 份子直方图上
+void histogram_avx2(const int32_t* p, size_t n, int32_t lo, unsigned shift, uint32_t* counts, unsigned bins) {
+    uint32_t sub[4][MAX_HISTOGRAM_BINS] = {};
+    const __m256i vlo = _mm256_set1_epi32(lo);
+    const __m256i vtop = _mm256_set1_epi32(static_cast<int32_t>(bins - 1));
+    const __m128i vshift = _mm_cvtsi32_si128(static_cast<int>(shift));
+    alignas(32) uint32_t idx[8];
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_max_epi32(load8(p + i), vlo);
+        __m256i b = _mm256_min_epu32(_mm256_srl_epi32(_mm256_sub_epi32(v, vlo), vshift), vtop);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(idx), b);
+        ++sub[0][idx[0]];
+        ++sub[1][idx[1]];
+        ++sub[2][idx[2]];
+        ++sub[3][idx[3]];
+        ++sub[0][idx[4]];
+        ++sub[1][idx[5]];
+        ++sub[2][idx[6]];
+        ++sub[3][idx[7]];
+    }
+    for (; i < n; ++i) {
+        uint32_t d = static_cast<uint32_t>(std::max(p[i], lo)) - static_cast<uint32_t>(lo);
+        ++sub[0][std::min<uint32_t>(d >> shift, bins - 1)];
+    }
+    for (unsigned b = 0; b < bins; ++b) {
+        counts[b] = sub[0][b] + sub[1][b] + sub[2][b] + sub[3][b];
+    }
+}
+
+}  // namespace
+
+const AnalyticsKernels analytics_kernels_avx2 = {
+    minmax_avx2, argmax_avx2, inclusive_scan_avx2, filter_gt_avx2, histogram_avx2,
+};
+
+}  // namespace simd
@@ -0,0 +1,223 @@
+#include <cpuid.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+#include "Autotune.h"
+
+namespace simd {
+
+namespace {
+
+// 每档调优时用的数据量，取在该档中间
+constexpr size_t TUNE_BYTES[] = {16 << 10, 512 << 10, 8 << 20, 64 << 20};
+
+// CPU 品牌字符串，空格换成下划线，作为 profile 的第一列
+std::string cpu_model() {
+    unsigned regs[12] = {};
+    for (unsigned i = 0; i < 3; ++i) {
+        if (!__get_cpuid(0x80000002 + i, &regs[4 * i], &regs[4 * i + 1], &regs[4 * i + 2], &regs[4 * i + 3])) {
+            return "unknown";
+        }
+    }
+    std::string name(reinterpret_cast<const char*>(regs), sizeof(regs));
+    name = name.c_str();
+    std::string out;
+    for (char c : name) {
+        if (c == ' ') {
+            if (!out.empty() && out.back() != '_') out += '_';
+        } else {
+            out += c;
+        }
+    }
+    while (!out.empty() && out.back() == '_') {
+        out.pop_back();
+    }
+    return out.empty() ? "unknown" : out;
+}
+
+struct TuneState {
+    std::mutex mu;
+    bool profile_loaded = false;
+    std::atomic<const SumVariant*> table[4][4] = {};
+};
+
+TuneState& tune_state() {
+    static TuneState s;
+    return s;
+}
+
+const SumVariant* find_variant(std::span<const SumVariant> variants, unsigned acc, unsigned unroll) {
+    for (const auto& v : variants) {
+        if (v.acc == acc && v.unroll == unroll) return &v;
+    }
+    return nullptr;
+}
+
+template<typename E, size_t N>
+bool parse_enum(const std::string& s, E& out, const char* (*name)(E)) {
+    for (size_t i = 0; i < N; ++i) {
+        if (s == name(static_cast<E>(i))) {
+            out = static_cast<E>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// 调用者持有 mu
+void load_profile(TuneState& s) {
+    s.profile_loaded = true;
+    std::string path = profile_path();
+    if (path.empty()) return;
+    std::ifstream in(path);
+    const std::string cpu = cpu_model();
+    const char* isa = isa_name(active_isa());
+    auto variants = sum_variants(active_isa());
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream ls(line);
+        std::string c, i, t, z;
+        unsigned acc, unroll;
+        if (!(ls >> c >> i >> t >> z >> acc >> unroll)) continue;
+        if (c != cpu || i != isa) continue;
+        ElemType type;
+        SizeClass cls;
+        if (!parse_enum<ElemType, 4>(t, type, elem_type_name) || !parse_enum<SizeClass, 4>(z, cls, size_class_name)) {
+            continue;
+        }
+        if (const SumVariant* v = find_variant(variants, acc, unroll)) {
+            s.table[int(type)][int(cls)].store(v, std::memory_order_release);
+        }
+    }
+}
+
+void append_profile(ElemType type, SizeClass cls, const SumVariant& v) {
+    std::string path = profile_path();
+    if (path.empty()) return;
+    // 默认路径的 ~/.cache 可能还不存在
+    auto slash = path.rfind('/');
+    if (slash != std::string::npos && slash > 0) mkdir(path.substr(0, slash).c_str(), 0755);
+    std::ofstream out(path, std::ios::app);
+    out << cpu_model() << ' ' << isa_name(active_isa()) << ' ' << elem_type_name(type) << ' '
+        << size_class_name(cls) << ' ' << v.acc << ' ' << v.unroll << '\n';
+}
+
+double run_once(const SumKernels& k, ElemType type, const void* p, size_t bytes) {
+    switch (type) {
+        case ElemType::I32: return double(k.i32(static_cast<const int32_t*>(p), bytes / sizeof(int32_t)));
+        case ElemType::I64: return double(k.i64(static_cast<const int64_t*>(p), bytes / sizeof(int64_t)));
+        case ElemType::F32: return k.f32(static_cast<const float*>(p), bytes / sizeof(float));
+        case ElemType::F64: return k.f64(static_cast<const double*>(p), bytes / sizeof(double));
+    }
+    return 0;
+}
+
+// 预热一次后测 3 轮，每轮至少 2ms，取单次调用的最短时间
+double measure_ns(const SumVariant& v, ElemType type, const void* p, size_t bytes) {
+    volatile double sink = run_once(v.kernels, type, p, bytes);
+    double best = 1e300;
+    for (int trial = 0; trial < 3; ++trial) {
+        auto start = std::chrono::steady_clock::now();
+        size_t calls = 0;
+        double ns;
+        do {
+            sink = sink + run_once(v.kernels, type, p, bytes);
+            ++calls;
+            ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        } while (ns < 2e6);
+        best = std::min(best, ns / calls);
+    }
+    return best;
+}
+
+const SumVariant& tune(ElemType type, SizeClass cls) {
+    auto variants = sum_variants(active_isa());
+    const size_t bytes = TUNE_BYTES[int(cls)];
+    void* buf = std::aligned_alloc(64, bytes);
+    memset(buf, 0, bytes);
+
+    const SumVariant* best = &variants[0];
+    double best_ns = 1e300;
+    for (const auto& v : variants) {
+        double ns = measure_ns(v, type, buf, bytes);
+        if (ns < best_ns) {
+            best_ns = ns;
+            best = &v;
+        }
+    }
+    std::free(buf);
+    return *best;
+}
+
+}  // namespace
+
+const char* elem_type_name(ElemType type) {
+    switch (type) {
+        case ElemType::I32: return "i32";
+        case ElemType::I64: return "i64";
+        case ElemType::F32: return "f32";
+        case ElemType::F64: return "f64";
+    }
+    return "?";
+}
+
+const char* size_class_name(SizeClass cls) {
+    switch (cls) {
+        case SizeClass::L1: return "L1";
+        case SizeClass::L2: return "L2";
+        case SizeClass::LLC: return "LLC";
+        case SizeClass::DRAM: return "DRAM";
+    }
+    return "?";
+}
+
+SizeClass size_class(size_t bytes) {
+    if (bytes <= (32 << 10)) return SizeClass::L1;
+    if (bytes <= (1 << 20)) return SizeClass::L2;
+    if (bytes <= (32 << 20)) return SizeClass::LLC;
+    return SizeClass::DRAM;
+}
+
+std::string profile_path() {
+    if (const char* p = std::getenv("SIMD_PROFILE")) return p;
+    if (const char* home = std::getenv("HOME")) return std::string(home) + "/.cache/hpp_simd_profile";
+    return {};
+}
+
+const SumVariant& tuned_variant(ElemType type, SizeClass cls) {
+    TuneState& s = tune_state();
+    auto& slot = s.table[int(type)][int(cls)];
+    if (const SumVariant* v = slot.load(std::memory_order_acquire)) return *v;
+
+    std::lock_guard<std::mutex> lock(s.mu);
+    if (!s.profile_loaded) load_profile(s);
+    if (const SumVariant* v = slot.load(std::memory_order_acquire)) return *v;
+
+    const SumVariant& v = tune(type, cls);
+    slot.store(&v, std::memory_order_release);
+    append_profile(type, cls, v);
+    return v;
+}
+
+int64_t tuned_sum(const int32_t* p, size_t n) {
+    return tuned_variant(ElemType::I32, size_class(n * sizeof(*p))).kernels.i32(p, n);
+}
+int64_t tuned_sum(const int64_t* p, size_t n) {
+    return tuned_variant(ElemType::I64, size_class(n * sizeof(*p))).kernels.i64(p, n);
+}
+double tuned_sum(const float* p, size_t n) {
+    return tuned_variant(ElemType::F32, size_class(n * sizeof(*p))).kernels.f32(p, n);
+}
+double tuned_sum(const double* p, size_t n) {
+    return tuned_variant(ElemType::F64, size_class(n * sizeof(*p))).kernels.f64(p, n);
+}
+
+}  // namespace simd
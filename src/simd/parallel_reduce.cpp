@@ -0,0 +1,59 @@
+#include "ParallelReduce.h"
+#include "Topology.h"
+
+namespace simd {
+
+ThreadTeam::ThreadTeam(unsigned threads) {
+    if (threads == 0) threads = topo::default_threads();
+    // 没指定 --pin 时和以前一样：第 i 个线程绑到进程允许的第 i % N 个 CPU
+    const topo::Topology& topology = topo::Topology::get();
+    std::vector<unsigned> cpus = topo::plan(topology, topo::policy(), threads);
+    if (topo::policy() == topo::Policy::None && !topology.cpus().empty()) {
+        for (unsigned i = 0; i < threads; ++i) {
+            cpus.push_back(topology.cpus()[i % topology.cpus().size()].id);
+        }
+    }
+    workers_.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        workers_.emplace_back([this, i] { worker_loop(i); });
+        if (!cpus.empty()) topo::pin_to(workers_.back(), cpus[i]);
+    }
+}
+
+ThreadTeam::~ThreadTeam() {
+    stopping_ = true;
+    generation_.fetch_add(1, std::memory_order_release);
+    generation_.notify_all();
+    for (auto& t : workers_) {
+        t.join();
+    }
+}
+
+void ThreadTeam::run(const std::function<void(unsigned)>& fn) {
+    job_ = &fn;
+    pending_.store(size(), std::memory_order_relaxed);
+    generation_.fetch_add(1, std::memory_order_release);
+    generation_.notify_all();
+
+    unsigned left;
+    while ((left = pending_.load(std::memory_order_acquire)) != 0) {
+        pending_.wait(left, std::memory_order_acquire);
+    }
+    job_ = nullptr;
+}
+
+void ThreadTeam::worker_loop(unsigned index) {
+    uint64_t seen = 0;
+    for (;;) {
+        generation_.wait(seen, std::memory_order_acquire);
+        seen = generation_.load(std::memory_order_acquire);
+        if (stopping_) return;
+
+        (*job_)(index);
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            pending_.notify_one();
+        }
+    }
+}
+
+}  // namespace simd
@@ -0,0 +1,110 @@
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+
+#include "Reduce.h"
+#include "ReduceKernels.h"
+
+namespace simd {
+
+const char* isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar: return "scalar";
+        case Isa::SSE42: return "sse4.2";
+        case Isa::AVX2: return "avx2";
+        case Isa::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+static bool cpu_supports(Isa isa) {
+    __builtin_cpu_init();
+    switch (isa) {
+        case Isa::Scalar: return true;
+        case Isa::SSE42: return __builtin_cpu_supports("sse4.2");
+        case Isa::AVX2: return __builtin_cpu_supports("avx2");
+        case Isa::AVX512: return __builtin_cpu_supports("avx512f");
+    }
+    return false;
+}
+
+static const SumKernels* compiled_kernels(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar: return &sum_kernels_scalar;
+#ifdef SIMD_HAVE_SSE42
+        case Isa::SSE42: return &sum_kernels_sse42;
+#endif
+#ifdef SIMD_HAVE_AVX2
+        case Isa::AVX2: return &sum_kernels_avx2;
+#endif
+#ifdef SIMD_HAVE_AVX512
+        case Isa::AVX512: return &sum_kernels_avx512;
+#endif
+        default: return nullptr;
+    }
+}
+
+static const SumGrid* compiled_grid(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar: return &sum_grid_scalar;
+#ifdef SIMD_HAVE_SSE42
+        case Isa::SSE42: return &sum_grid_sse42;
+#endif
+#ifdef SIMD_HAVE_AVX2
+        case Isa::AVX2: return &sum_grid_avx2;
+#endif
+#ifdef SIMD_HAVE_AVX512
+        case Isa::AVX512: return &sum_grid_avx512;
+#endif
+        default: return nullptr;
+    }
+}
+
+const SumKernels* sum_kernels(Isa isa) {
+    if (!cpu_supports(isa)) return nullptr;
+    return compiled_kernels(isa);
+}
+
+std::span<const SumVariant> sum_variants(Isa isa) {
+    const SumGrid* grid = cpu_supports(isa) ? compiled_grid(isa) : nullptr;
+    if (!grid) return {};
+    return *grid;
+}
+
+Isa detect_isa() {
+    for (Isa isa : {Isa::AVX512, Isa::AVX2, Isa::SSE42}) {
+        if (sum_kernels(isa)) return isa;
+    }
+    return Isa::Scalar;
+}
+
+Isa active_isa() {
+    static const Isa isa = [] {
+        Isa best = detect_isa();
+        const char* env = std::getenv("SIMD_ISA");
+        if (!env) return best;
+        for (Isa cap : {Isa::Scalar, Isa::SSE42, Isa::AVX2, Isa::AVX512}) {
+            if (std::strcmp(env, isa_name(cap)) == 0) {
+                // 只能往下限制；中间等级没编译进来时继续往下找
+                for (int i = static_cast<int>(cap < best ? cap : best); i > 0; --i) {
+                    if (sum_kernels(static_cast<Isa>(i))) return static_cast<Isa>(i);
+                }
+                return Isa::Scalar;
+            }
+        }
+        return best;
+    }();
+    return isa;
+}
+
+static const SumKernels& active_kernels() {
+    static const SumKernels* k = sum_kernels(active_isa());
+    return *k;
+}
+
+int64_t sum(const int32_t* p, size_t n) { return active_kernels().i32(p, n); }
+int64_t sum(const int64_t* p, size_t n) { return active_kernels().i64(p, n); }
+double sum(const float* p, size_t n) { return active_kernels().f32(p, n); }
+double sum(const double* p, size_t n) { return active_kernels().f64(p, n); }
+
+}  // namespace simd
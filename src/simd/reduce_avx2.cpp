@@ -0,0 +1,75 @@
+#include <immintrin.h>
+
+#include "ReduceKernels.h"
+
+// 本文件以 -mavx2 编译；int32 的加宽用带内存操作数的 vpmovsxdq，一条指令完成 load + 符号扩展
+namespace simd {
+
+namespace {
+
+struct I32Ops {
+    using T = int32_t;
+    using Result = int64_t;
+    using Vec = __m256i;
+    static constexpr size_t WIDTH = 4;
+    static constexpr size_t ALIGN = 16;
+    static Vec zero() { return _mm256_setzero_si256(); }
+    static Vec load(const T* p) { return _mm256_cvtepi32_epi64(_mm_load_si128(reinterpret_cast<const __m128i*>(p))); }
+    static Vec add(Vec a, Vec b) { return _mm256_add_epi64(a, b); }
+    static Result hsum(Vec v) {
+        __m128i s = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        return _mm_cvtsi128_si64(s) + _mm_extract_epi64(s, 1);
+    }
+};
+
+struct I64Ops {
+    using T = int64_t;
+    using Result = int64_t;
+    using Vec = __m256i;
+    static constexpr size_t WIDTH = 4;
+    static constexpr size_t ALIGN = 32;
+    static Vec zero() { return _mm256_setzero_si256(); }
+    static Vec load(const T* p) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(p)); }
+    static Vec add(Vec a, Vec b) { return _mm256_add_epi64(a, b); }
+    static Result hsum(Vec v) { return I32Ops::hsum(v); }
+};
+
+struct F32Ops {
+    using T = float;
+    using Result = double;
+    using Vec = __m256d;
+    static constexpr size_t WIDTH = 4;
+    static constexpr size_t ALIGN = 16;
+    static Vec zero() { return _mm256_setzero_pd(); }
+    static Vec load(const T* p) { return _mm256_cvtps_pd(_mm_load_ps(p)); }
+    static Vec add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+    static Result hsum(Vec v) {
+        __m128d s = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+    }
+};
+
+struct F64Ops {
+    using T = double;
+    using Result = double;
+    using Vec = __m256d;
+    static constexpr size_t WIDTH = 4;
+    static constexpr size_t ALIGN = 32;
+    static Vec zero() { return _mm256_setzero_pd(); }
+    static Vec load(const T* p) { return _mm256_load_pd(p); }
+    static Vec add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+    static Result hsum(Vec v) { return F32Ops::hsum(v); }
+};
+
+}  // namespace
+
+const SumKernels sum_kernels_avx2 = {
+    sum_loop<I32Ops>,
+    sum_loop<I64Ops>,
+    sum_loop<F32Ops>,
+    sum_loop<F64Ops>,
+};
+
+const SumGrid sum_grid_avx2 = make_sum_grid<I32Ops, I64Ops, F32Ops, F64Ops>();
+
+}  // namespace simd
@@ -0,0 +1,82 @@
+#include <immintrin.h>
+
+#include "ReduceKernels.h"
+
+// 本文件以 -mavx512f 编译
+namespace simd {
+
+namespace {
+
+// 只在最后做一次，直接存出来相加；GCC 12 的 _mm512_reduce_add_* 在这里会报 -Wuninitialized
+inline int64_t hsum_epi64(__m512i v) {
+    alignas(64) int64_t lanes[8];
+    _mm512_store_si512(lanes, v);
+    return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+inline double hsum_pd(__m512d v) {
+    alignas(64) double lanes[8];
+    _mm512_store_pd(lanes, v);
+    return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+struct I32Ops {
+    using T = int32_t;
+    using Result = int64_t;
+    using Vec = __m512i;
+    static constexpr size_t WIDTH = 8;
+    static constexpr size_t ALIGN = 32;
+    static Vec zero() { return _mm512_setzero_si512(); }
+    static Vec load(const T* p) { return _mm512_cvtepi32_epi64(_mm256_load_si256(reinterpret_cast<const __m256i*>(p))); }
+    static Vec add(Vec a, Vec b) { return _mm512_add_epi64(a, b); }
+    static Result hsum(Vec v) { return hsum_epi64(v); }
+};
+
+struct I64Ops {
+    using T = int64_t;
+    using Result = int64_t;
+    using Vec = __m512i;
+    static constexpr size_t WIDTH = 8;
+    static constexpr size_t ALIGN = 64;
+    static Vec zero() { return _mm512_setzero_si512(); }
+    static Vec load(const T* p) { return _mm512_load_si512(p); }
+    static Vec add(Vec a, Vec b) { return _mm512_add_epi64(a, b); }
+    static Result hsum(Vec v) { return hsum_epi64(v); }
+};
+
+struct F32Ops {
+    using T = float;
+    using Result = double;
+    using Vec = __m512d;
+    static constexpr size_t WIDTH = 8;
+    static constexpr size_t ALIGN = 32;
+    static Vec zero() { return _mm512_setzero_pd(); }
+    static Vec load(const T* p) { return _mm512_cvtps_pd(_mm256_load_ps(p)); }
+    static Vec add(Vec a, Vec b) { return _mm512_add_pd(a, b); }
+    static Result hsum(Vec v) { return hsum_pd(v); }
+};
+
+struct F64Ops {
+    using T = double;
+    using Result = double;
+    using Vec = __m512d;
+    static constexpr size_t WIDTH = 8;
+    static constexpr size_t ALIGN = 64;
+    static Vec zero() { return _mm512_setzero_pd(); }
+    static Vec load(const T* p) { return _mm512_load_pd(p); }
+    static Vec add(Vec a, Vec b) { return _mm512_add_pd(a, b); }
+    static Result hsum(Vec v) { return hsum_pd(v); }
+};
+
+}  // namespace
+
+const SumKernels sum_kernels_avx512 = {
+    sum_loop<I32Ops>,
+    sum_loop<I64Ops>,
+    sum_loop<F32Ops>,
+    sum_loop<F64Ops>,
+};
+
+const SumGrid sum_grid_avx512 = make_sum_grid<I32Ops, I64Ops, F32Ops, F64Ops>();
+
+}  // namespace simd
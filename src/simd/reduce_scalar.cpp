@@ -0,0 +1,38 @@
+#include "ReduceKernels.h"
+
+namespace simd {
+
+namespace {
+
+// 标量也走 sum_loop：向量宽度为 1，累加器就是加宽后的标量。
+// 默认的 4 个累加器对应 test_sum 里的 BM_Sum_MultiAccum
+template<typename Elem, typename Acc>
+struct ScalarOps {
+    using T = Elem;
+    using Result = Acc;
+    using Vec = Acc;
+    static constexpr size_t WIDTH = 1;
+    static constexpr size_t ALIGN = alignof(Elem);
+    static Vec zero() { return 0; }
+    static Vec load(const T* p) { return *p; }
+    static Vec add(Vec a, Vec b) { return a + b; }
+    static Result hsum(Vec v) { return v; }
+};
+
+using I32Ops = ScalarOps<int32_t, int64_t>;
+using I64Ops = ScalarOps<int64_t, int64_t>;
+using F32Ops = ScalarOps<float, double>;
+using F64Ops = ScalarOps<double, double>;
+
+}  // namespace
+
+const SumKernels sum_kernels_scalar = {
+    sum_loop<I32Ops>,
+    sum_loop<I64Ops>,
+    sum_loop<F32Ops>,
+    sum_loop<F64Ops>,
+};
+
+const SumGrid sum_grid_scalar = make_sum_grid<I32Ops, I64Ops, F32Ops, F64Ops>();
+
+}  // namespace simd
@@ -0,0 +1,69 @@
+#include <immintrin.h>
+
+#include "ReduceKernels.h"
+
+// 本文件以 -msse4.2 编译
+namespace simd {
+
+namespace {
+
+struct I32Ops {
+    using T = int32_t;
+    using Result = int64_t;
+    using Vec = __m128i;
+    static constexpr size_t WIDTH = 2;
+    static constexpr size_t ALIGN = 8;
+    static Vec zero() { return _mm_setzero_si128(); }
+    static Vec load(const T* p) { return _mm_cvtepi32_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))); }
+    static Vec add(Vec a, Vec b) { return _mm_add_epi64(a, b); }
+    static Result hsum(Vec v) { return _mm_cvtsi128_si64(v) + _mm_extract_epi64(v, 1); }
+};
+
+struct I64Ops {
+    using T = int64_t;
+    using Result = int64_t;
+    using Vec = __m128i;
+    static constexpr size_t WIDTH = 2;
+    static constexpr size_t ALIGN = 16;
+    static Vec zero() { return _mm_setzero_si128(); }
+    static Vec load(const T* p) { return _mm_load_si128(reinterpret_cast<const __m128i*>(p)); }
+    static Vec add(Vec a, Vec b) { return _mm_add_epi64(a, b); }
+    static Result hsum(Vec v) { return _mm_cvtsi128_si64(v) + _mm_extract_epi64(v, 1); }
+};
+
+struct F32Ops {
+    using T = float;
+    using Result = double;
+    using Vec = __m128d;
+    static constexpr size_t WIDTH = 2;
+    static constexpr size_t ALIGN = 8;
+    static Vec zero() { return _mm_setzero_pd(); }
+    static Vec load(const T* p) { return _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)))); }
+    static Vec add(Vec a, Vec b) { return _mm_add_pd(a, b); }
+    static Result hsum(Vec v) { return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v))); }
+};
+
+struct F64Ops {
+    using T = double;
+    using Result = double;
+    using Vec = __m128d;
+    static constexpr size_t WIDTH = 2;
+    static constexpr size_t ALIGN = 16;
+    static Vec zero() { return _mm_setzero_pd(); }
+    static Vec load(const T* p) { return _mm_load_pd(p); }
+    static Vec add(Vec a, Vec b) { return _mm_add_pd(a, b); }
+    static Result hsum(Vec v) { return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v))); }
+};
+
+}  // namespace
+
+const SumKernels sum_kernels_sse42 = {
+    sum_loop<I32Ops>,
+    sum_loop<I64Ops>,
+    sum_loop<F32Ops>,
+    sum_loop<F64Ops>,
+};
+
+const SumGrid sum_grid_sse42 = make_sum_grid<I32Ops, I64Ops, F32Ops, F64Ops>();
+
+}  // namespace simd
@@ -0,0 +1,39 @@
+#ifndef __STATS_BENCHHISTOGRAM__
+#define __STATS_BENCHHISTOGRAM__
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "Histogram.h"
+
+// 把延迟直方图接到 Google Benchmark 上：p50 / p99 / p99.9 / max 作为用户计数器。
+// 多线程基准只在一个线程上调用（计数器会按线程相加），而且要在 for (auto _ : state) 之后——
+// 循环结束时各线程之间有一道栅栏，那时别的线程的记录都已完成。
+// 设了环境变量 HPP_HIST_DIR 时再把完整分布写成 <目录>/<file>.csv 和 <file>.json，
+// 同一个基准的多次运行（包括框架估计迭代数的那几次）只留最后一次
+namespace stats {
+
+inline void report(benchmark::State& state, const HistogramSnapshot& h, const std::string& file, double per_ns = 1) {
+    state.counters["p50_ns"] = h.percentile(0.5) / per_ns;
+    state.counters["p99_ns"] = h.percentile(0.99) / per_ns;
+    state.counters["p999_ns"] = h.percentile(0.999) / per_ns;
+    state.counters["max_ns"] = h.max() / per_ns;
+
+    const char* dir = getenv("HPP_HIST_DIR");
+    if (!dir || !*dir) return;
+    const std::string base = std::string(dir) + "/" + file;
+    if (FILE* f = fopen((base + ".csv").c_str(), "w")) {
+        h.write_csv(f, per_ns);
+        fclose(f);
+    }
+    if (FILE* f = fopen((base + ".json").c_str(), "w")) {
+        h.write_json(f, per_ns);
+        fclose(f);
+    }
+}
+
+}  // namespace stats
+
+#endif /* __STATS_BENCHHISTOGRAM__ */
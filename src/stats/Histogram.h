@@ -0,0 +1,262 @@
+#ifndef __STATS_HISTOGRAM__
+#define __STATS_HISTOGRAM__
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "ShardedCounter.h"
+
+// HdrHistogram 风格的对数-线性直方图，记录延迟这类跨好几个数量级的值，给出 p99 / p99.9 等尾延迟。
+//
+// 小于 256 的值每个值一个桶；之后每个 2 的幂区间 [2^k, 2^(k+1)) 线性分成 128 个桶，
+// 所以任何值的相对误差都小于 1/128。超过 HIST_MAX_VALUE（2^44，按纳秒约 4.9 小时）的值记在最后一个桶。
+// 桶数固定（4864 个，约 38K），记录时不分配内存。
+//
+//   Histogram          单写者：只由一个线程 record，桶是 relaxed load + store 的原子变量（x86 上就是普通的
+//                      mov，没有 lock 前缀），任意线程可以随时无锁地取快照
+//   ShardedHistogram   多写者：每个线程按 ShardSlots 的槽位懒分配一个自己的 Histogram，读的时候合并
+//   HistogramSnapshot  普通数组形式的快照，可以合并，求百分位、均值，导出 CSV / JSON
+//
+// 快照和并发的 record 不是原子的：读到的各桶是"差不多同一时刻"的值，总数按读到的各桶相加，自洽
+namespace stats {
+
+constexpr unsigned HIST_SUB_BITS = 8;
+constexpr unsigned HIST_MAX_BITS = 44;
+constexpr uint64_t HIST_MAX_VALUE = (uint64_t(1) << HIST_MAX_BITS) - 1;
+
+namespace detail {
+
+// 值 -> 桶：shift = 值的位宽超出 HIST_SUB_BITS 的部分，桶内下标取值的高 HIST_SUB_BITS 位
+constexpr unsigned hist_index(uint64_t v) {
+    v = std::min(v, HIST_MAX_VALUE);
+    const unsigned shift = unsigned(std::bit_width(v | ((uint64_t(1) << HIST_SUB_BITS) - 1))) - HIST_SUB_BITS;
+    return (shift << (HIST_SUB_BITS - 1)) + unsigned(v >> shift);
+}
+
+constexpr unsigned hist_shift(unsigned index) {
+    return index < (1u << HIST_SUB_BITS) ? 0 : (index >> (HIST_SUB_BITS - 1)) - 1;
+}
+
+// 桶里最小的值
+constexpr uint64_t hist_lowest(unsigned index) {
+    const unsigned shift = hist_shift(index);
+    return uint64_t(index - (shift << (HIST_SUB_BITS - 1))) << shift;
+}
+
+// 桶里最大的值
+constexpr uint64_t hist_highest(unsigned index) {
+    return hist_lowest(index) + (uint64_t(1) << hist_shift(index)) - 1;
+}
+
+}  // namespace detail
+
+constexpr unsigned HIST_BUCKETS = detail::hist_index(HIST_MAX_VALUE) + 1;
+
+static_assert(detail::hist_index(255) == 255 && detail::hist_index(256) == 256);
+static_assert(detail::hist_lowest(detail::hist_index(1000)) <= 1000 && detail::hist_highest(detail::hist_index(1000)) >= 1000);
+static_assert(detail::hist_highest(HIST_BUCKETS - 1) == HIST_MAX_VALUE);
+
+class HistogramSnapshot {
+public:
+    HistogramSnapshot() : counts_(HIST_BUCKETS) {}
+
+    void merge(const HistogramSnapshot& other) {
+        for (unsigned i = 0; i < HIST_BUCKETS; ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        count_ += other.count_;
+        sum_ += other.sum_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    uint64_t count() const { return count_; }
+    uint64_t min() const { return count_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ ? double(sum_) / double(count_) : 0; }
+
+    // p 取 [0, 1]，例如 0.999。返回第 ceil(p * count) 个值所在桶的上界（不超过实际最大值），
+    // 即"至少有 p 的样本不大于它"
+    uint64_t percentile(double p) const {
+        if (count_ == 0) return 0;
+        const uint64_t rank = std::max<uint64_t>(1, uint64_t(std::ceil(std::clamp(p, 0.0, 1.0) * double(count_))));
+        uint64_t seen = 0;
+        for (unsigned i = 0; i < HIST_BUCKETS; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) return std::min(detail::hist_highest(i), max_);
+        }
+        return max_;
+    }
+
+    // 一行摘要，divisor 把记录时的单位换算成 unit（例如 TSC 周期 -> 纳秒）
+    void print(FILE* out, const char* name, const char* unit = "ns", double divisor = 1) const {
+        fprintf(out, "  %-24s n=%-10llu avg=%-10.1f p50=%-10.1f p99=%-10.1f p999=%-10.1f max=%.1f %s\n", name,
+                (unsigned long long) count_, mean() / divisor, percentile(0.5) / divisor, percentile(0.99) / divisor,
+                percentile(0.999) / divisor, max_ / divisor, unit);
+    }
+
+    // 每个非空桶一行：桶上界、桶内个数、累计占比
+    void write_csv(FILE* out, double divisor = 1) const {
+        fprintf(out, "value,count,percentile\n");
+        uint64_t seen = 0;
+        for (unsigned i = 0; i < HIST_BUCKETS; ++i) {
+            if (counts_[i] == 0) continue;
+            seen += counts_[i];
+            fprintf(out, "%.10g,%llu,%.6f\n", std::min(detail::hist_highest(i), max_) / divisor,
+                    (unsigned long long) counts_[i], double(seen) / double(count_));
+        }
+    }
+
+    // 摘要 + 常用百分位 + 非空桶 [上界, 个数]
+    void write_json(FILE* out, double divisor = 1) const {
+        static constexpr std::pair<const char*, double> PERCENTILES[] = {
+            {"50", 0.5}, {"90", 0.9}, {"99", 0.99}, {"99.9", 0.999}, {"99.99", 0.9999}};
+        fprintf(out, "{\"count\":%llu,\"min\":%.10g,\"max\":%.10g,\"mean\":%.10g,\"percentiles\":{",
+                (unsigned long long) count_, min() / divisor, max_ / divisor, mean() / divisor);
+        for (size_t i = 0; i < std::size(PERCENTILES); ++i) {
+            fprintf(out, "%s\"%s\":%.10g", i ? "," : "", PERCENTILES[i].first, percentile(PERCENTILES[i].second) / divisor);
+        }
+        fprintf(out, "},\"buckets\":[");
+        bool first = true;
+        for (unsigned i = 0; i < HIST_BUCKETS; ++i) {
+            if (counts_[i] == 0) continue;
+            fprintf(out, "%s[%.10g,%llu]", first ? "" : ",", std::min(detail::hist_highest(i), max_) / divisor,
+                    (unsigned long long) counts_[i]);
+            first = false;
+        }
+        fprintf(out, "]}\n");
+    }
+
+private:
+    friend class Histogram;
+
+    std::vector<uint64_t> counts_;
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0;
+};
+
+class Histogram {
+public:
+    // 只能由一个线程调用（同一时刻）
+    void record(uint64_t v) {
+        bump(counts_[detail::hist_index(v)], 1);
+        bump(sum_, v);
+        if (v < min_.load(std::memory_order_relaxed)) min_.store(v, std::memory_order_relaxed);
+        if (v > max_.load(std::memory_order_relaxed)) max_.store(v, std::memory_order_relaxed);
+    }
+
+    // 把当前内容加进 out，任意线程可调用
+    void add_to(HistogramSnapshot& out) const {
+        for (unsigned i = 0; i < HIST_BUCKETS; ++i) {
+            const uint64_t n = counts_[i].load(std::memory_order_relaxed);
+            out.counts_[i] += n;
+            out.count_ += n;
+        }
+        out.sum_ += sum_.load(std::memory_order_relaxed);
+        out.min_ = std::min(out.min_, min_.load(std::memory_order_relaxed));
+        out.max_ = std::max(out.max_, max_.load(std::memory_order_relaxed));
+    }
+
+    HistogramSnapshot snapshot() const {
+        HistogramSnapshot s;
+        add_to(s);
+        return s;
+    }
+
+    // 和并发的 record 不是原子的，只用于测量区间之间清零
+    void reset() {
+        for (auto& c : counts_) {
+            c.store(0, std::memory_order_relaxed);
+        }
+        sum_.store(0, std::memory_order_relaxed);
+        min_.store(UINT64_MAX, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static void bump(std::atomic<uint64_t>& a, uint64_t d) {
+        a.store(a.load(std::memory_order_relaxed) + d, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> counts_[HIST_BUCKETS]{};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> min_{UINT64_MAX};
+    std::atomic<uint64_t> max_{0};
+};
+
+// 任意线程 record。槽位在同一时刻只属于一个线程（线程退出后才会交给别的线程），所以每个分片仍是单写者；
+// 槽位超过 MAX_SHARDS 的线程共用一个加锁的分片
+class ShardedHistogram {
+public:
+    static constexpr unsigned MAX_SHARDS = 256;
+
+    ShardedHistogram() = default;
+    ~ShardedHistogram() {
+        for (auto& s : shards_) {
+            delete s.load(std::memory_order_relaxed);
+        }
+    }
+
+    ShardedHistogram(const ShardedHistogram&) = delete;
+    ShardedHistogram& operator=(const ShardedHistogram&) = delete;
+
+    void record(uint64_t v) {
+        const unsigned slot = ShardSlots::current();
+        if (slot < MAX_SHARDS) [[likely]] {
+            if (Histogram* h = shards_[slot].load(std::memory_order_relaxed)) [[likely]] {
+                h->record(v);
+                return;
+            }
+        }
+        record_slow(slot, v);
+    }
+
+    HistogramSnapshot snapshot() const {
+        HistogramSnapshot s;
+        for (const auto& shard : shards_) {
+            if (const Histogram* h = shard.load(std::memory_order_acquire)) h->add_to(s);
+        }
+        std::lock_guard<std::mutex> lock(overflow_mu_);
+        overflow_.add_to(s);
+        return s;
+    }
+
+    // 和并发的 record 不是原子的，只用于测量区间之间清零
+    void reset() {
+        for (auto& shard : shards_) {
+            if (Histogram* h = shard.load(std::memory_order_acquire)) h->reset();
+        }
+        std::lock_guard<std::mutex> lock(overflow_mu_);
+        overflow_.reset();
+    }
+
+private:
+    [[gnu::noinline]] void record_slow(unsigned slot, uint64_t v) {
+        if (slot >= MAX_SHARDS) {
+            std::lock_guard<std::mutex> lock(overflow_mu_);
+            overflow_.record(v);
+            return;
+        }
+        // 只有占着这个槽位的线程会走到这里，不需要 CAS
+        Histogram* h = new Histogram;
+        h->record(v);
+        shards_[slot].store(h, std::memory_order_release);
+    }
+
+    std::atomic<Histogram*> shards_[MAX_SHARDS]{};
+    mutable std::mutex overflow_mu_;
+    Histogram overflow_;
+};
+
+}  // namespace stats
+
+#endif /* __STATS_HISTOGRAM__ */
@@ -0,0 +1,173 @@
+#ifndef __STATS_SHARDEDCOUNTER__
+#define __STATS_SHARDEDCOUNTER__
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+// 多线程写、偶尔读的计数器。
+//
+// 每个线程第一次用到时从进程级的槽位表里领一个下标（thread_local，线程退出时归还给后来的线程），
+// 计数器按下标把增量写到各自独占缓存行的分片上，写路径是一次 relaxed fetch_add，不和别的线程争缓存行。
+// 读的时候把所有分片加起来：只保证最终一致，读到的是某个"差不多同时"的快照。
+// 线程数超过分片数时几个线程共用一片，结果仍然正确，只是又有了竞争
+namespace stats {
+
+#if defined(__cpp_lib_hardware_interference_size)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+// 只在本进程内使用，不是 ABI 的一部分，可以放心用编译器给出的值
+constexpr size_t CACHE_LINE = std::hardware_destructive_interference_size;
+#pragma GCC diagnostic pop
+#else
+constexpr size_t CACHE_LINE = 64;
+#endif
+
+// 进程级的线程槽位分配：空闲下标放在小根堆里，优先复用最小的已释放下标
+class ShardSlots {
+public:
+    // 当前线程的槽位，首次调用时分配。快路径读的是可平凡初始化的 thread_local，
+    // 不经过带析构函数的 thread_local 那层初始化检查
+    static unsigned current() {
+        static thread_local unsigned cached = UNASSIGNED;
+        if (cached != UNASSIGNED) [[likely]] return cached;
+        return cached = assign();
+    }
+
+    // 至今分配过的最大槽位数 + 1
+    static unsigned high_water() { return instance().next_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr unsigned UNASSIGNED = ~0u;
+
+    // 线程退出时 Holder 析构，把下标还回去
+    [[gnu::noinline]] static unsigned assign() {
+        thread_local Holder holder;
+        return holder.index;
+    }
+
+    struct Holder {
+        unsigned index;
+        Holder() : index(instance().acquire()) {}
+        ~Holder() { instance().release(index); }
+    };
+
+    static ShardSlots& instance() {
+        // 故意泄漏：线程退出时的 release 可能晚于静态对象析构
+        static ShardSlots* slots = new ShardSlots;
+        return *slots;
+    }
+
+    unsigned acquire() {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (!free_.empty()) {
+            std::pop_heap(free_.begin(), free_.end(), std::greater<>{});
+            unsigned index = free_.back();
+            free_.pop_back();
+            return index;
+        }
+        return next_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release(unsigned index) {
+        std::lock_guard<std::mutex> lock(mu_);
+        free_.push_back(index);
+        std::push_heap(free_.begin(), free_.end(), std::greater<>{});
+    }
+
+    std::mutex mu_;
+    std::vector<unsigned> free_;
+    std::atomic<unsigned> next_{0};
+};
+
+namespace detail {
+
+template<typename T>
+struct alignas(CACHE_LINE) Shard {
+    std::atomic<T> value{0};
+};
+
+// 分片数取 2 的幂，默认为硬件线程数向上取整
+inline unsigned default_shards() {
+    return std::bit_ceil(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+template<typename T>
+class ShardedValue {
+public:
+    explicit ShardedValue(unsigned shards = default_shards())
+        : mask_(std::bit_ceil(std::max(1u, shards)) - 1), shards_(new Shard<T>[mask_ + 1]) {}
+
+    ShardedValue(const ShardedValue&) = delete;
+    ShardedValue& operator=(const ShardedValue&) = delete;
+
+    void add(T delta) { local().value.fetch_add(delta, std::memory_order_relaxed); }
+
+    T value() const {
+        T total = 0;
+        for (unsigned i = 0; i <= mask_; ++i) {
+            total += shards_[i].value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    // 和并发的 add 不是原子的，只用于测量区间之间清零
+    void reset() {
+        for (unsigned i = 0; i <= mask_; ++i) {
+            shards_[i].value.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    unsigned shards() const { return mask_ + 1; }
+
+private:
+    Shard<T>& local() { return shards_[ShardSlots::current() & mask_]; }
+
+    unsigned mask_;
+    std::unique_ptr<Shard<T>[]> shards_;
+};
+
+}  // namespace detail
+
+// 单调递增的计数：请求数、字节数、唤醒次数……
+class ShardedCounter {
+public:
+    explicit ShardedCounter(unsigned shards = detail::default_shards()) : v_(shards) {}
+
+    void inc() { v_.add(1); }
+    void add(uint64_t n) { v_.add(n); }
+    uint64_t value() const { return v_.value(); }
+    void reset() { v_.reset(); }
+    unsigned shards() const { return v_.shards(); }
+
+private:
+    detail::ShardedValue<uint64_t> v_;
+};
+
+// 可增可减的当前值：在途请求数、连接数、队列深度……
+// 同一个量常在不同线程上加减，单个分片可能为负，只有总和有意义
+class ShardedGauge {
+public:
+    explicit ShardedGauge(unsigned shards = detail::default_shards()) : v_(shards) {}
+
+    void inc() { v_.add(1); }
+    void dec() { v_.add(-1); }
+    void add(int64_t delta) { v_.add(delta); }
+    int64_t value() const { return v_.value(); }
+    void reset() { v_.reset(); }
+    unsigned shards() const { return v_.shards(); }
+
+private:
+    detail::ShardedValue<int64_t> v_;
+};
+
+}  // namespace stats
+
+#endif /* __STATS_SHARDEDCOUNTER__ */
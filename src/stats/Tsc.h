@@ -0,0 +1,46 @@
+#ifndef __STATS_TSC__
+#define __STATS_TSC__
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// 打时间戳用的时钟：x86 上直接读 TSC（约 20 个周期，不进内核），其他平台退回 steady_clock 的纳秒数。
+// 现代 x86 的 TSC 恒速且各核同步（/proc/cpuinfo 里的 constant_tsc、nonstop_tsc），
+// 一个线程打的时间戳可以在另一个线程上相减，用来量入队到出队这类跨线程延迟。
+// rdtsc 不是序列化指令，前后的指令可能越过它执行，测几十纳秒以上的区间时可以忽略
+namespace stats {
+
+inline uint64_t tsc_now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+// 每纳秒多少个 tsc_now() 的单位。第一次调用时对着 steady_clock 校准约 20ms
+inline double tsc_per_ns() {
+#if defined(__x86_64__) || defined(__i386__)
+    static const double ratio = [] {
+        using clock = std::chrono::steady_clock;
+        const auto t0 = clock::now();
+        const uint64_t c0 = __rdtsc();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        const auto t1 = clock::now();
+        const uint64_t c1 = __rdtsc();
+        const double ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        return ns > 0 ? double(c1 - c0) / ns : 1.0;
+    }();
+    return ratio;
+#else
+    return 1.0;
+#endif
+}
+
+}  // namespace stats
+
+#endif /* __STATS_TSC__ */
@@ -0,0 +1,166 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+#include "BenchCounters.h"
+#include "BenchPin.h"
+#include "MpmcRingBuffer.h"
+#include "SmallAlloc.h"
+#include "SpscRingBuffer.h"
+
+// 小对象分配器 vs glibc malloc。
+// 重点是生产者分配、消费者释放：malloc 下对象总是被还到消费者线程的 tcache / arena，
+// 生产者那边只能不断从 arena 里拿新的；SmallAlloc 把对象成批还给属主
+
+struct Malloc {
+    static void* allocate(size_t n) { return malloc(n); }
+    static void deallocate(void* p, size_t) { free(p); }
+};
+
+struct Small {
+    static void* allocate(size_t n) { return alloc::allocate(n); }
+    static void deallocate(void* p, size_t n) { alloc::deallocate(p, n); }
+};
+
+static constexpr int PER_ITER = 64;
+
+// 分配一批：地址互不相同、16 字节对齐、写得进去
+template<typename A>
+static bool self_check(size_t size) {
+    std::vector<void*> ps;
+    std::unordered_set<void*> seen;
+    bool ok = true;
+    for (int i = 0; i < 1000; ++i) {
+        void* p = A::allocate(size);
+        ok = ok && p && reinterpret_cast<uintptr_t>(p) % 16 == 0 && seen.insert(p).second;
+        memset(p, 0xab, size);
+        ps.push_back(p);
+    }
+    for (void* p : ps) {
+        A::deallocate(p, size);
+    }
+    return ok;
+}
+
+// SmallAlloc 至今切出的 span 数：生产者拿不回对象时会一直涨
+template<typename A>
+static void report_spans(benchmark::State& state) {
+    if constexpr (std::is_same_v<A, Small>) state.counters["spans"] = double(alloc::spans_mapped());
+}
+
+// ────────────────────────────────────────────────
+//  同一线程分配、释放
+// ────────────────────────────────────────────────
+
+template<typename A>
+static void BM_LocalChurn(benchmark::State& state) {
+    const size_t size = size_t(state.range(0));
+    if (!self_check<A>(size)) {
+        state.SkipWithError("self check failed");
+        return;
+    }
+    void* ps[PER_ITER];
+    perf::BenchCounters perf_counters(state);
+    for (auto _ : state) {
+        for (auto& p : ps) {
+            p = A::allocate(size);
+            benchmark::DoNotOptimize(p);
+        }
+        for (auto& p : ps) {
+            A::deallocate(p, size);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * PER_ITER);
+}
+BENCHMARK_TEMPLATE(BM_LocalChurn, Malloc)->Arg(32)->Arg(256)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_LocalChurn, Small)->Arg(32)->Arg(256)->Arg(1024);
+
+// ────────────────────────────────────────────────
+//  生产者分配 → SPSC 队列 → 消费者释放
+// ────────────────────────────────────────────────
+
+static SpscRingBuffer<void*, 1024> spsc_queue;
+
+template<typename A>
+static void BM_SpscHandoff(benchmark::State& state) {
+    const size_t size = size_t(state.range(0));
+    auto pinned = topo::pin(state);
+    perf::BenchCounters perf_counters(state);
+    if (state.thread_index() == 0) {
+        for (auto _ : state) {
+            for (int i = 0; i < PER_ITER; ++i) {
+                void* p = A::allocate(size);
+                *static_cast<size_t*>(p) = size;
+                while (!spsc_queue.try_push(p)) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * PER_ITER);
+    } else {
+        size_t bad = 0;
+        for (auto _ : state) {
+            for (int i = 0; i < PER_ITER; ++i) {
+                void* p;
+                while (!spsc_queue.try_pop(p)) {
+                    std::this_thread::yield();
+                }
+                bad += *static_cast<size_t*>(p) != size;
+                A::deallocate(p, size);
+            }
+        }
+        if (bad) state.SkipWithError("payload corrupted");
+        report_spans<A>(state);
+    }
+}
+BENCHMARK_TEMPLATE(BM_SpscHandoff, Malloc)->Threads(2)->Arg(32)->Arg(256)->Arg(1024)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SpscHandoff, Small)->Threads(2)->Arg(32)->Arg(256)->Arg(1024)->UseRealTime();
+
+// ────────────────────────────────────────────────
+//  偶数线程生产、奇数线程消费，经过 MPMC 队列
+// ────────────────────────────────────────────────
+
+static MpmcRingBuffer<void*, 4096> mpmc_queue;
+
+template<typename A>
+static void BM_MpmcHandoff(benchmark::State& state) {
+    const size_t size = size_t(state.range(0));
+    auto pinned = topo::pin(state);
+    perf::BenchCounters perf_counters(state);
+    if ((state.thread_index() & 1) == 0) {
+        for (auto _ : state) {
+            for (int i = 0; i < PER_ITER; ++i) {
+                void* p = A::allocate(size);
+                *static_cast<size_t*>(p) = size;
+                while (!mpmc_queue.try_emplace(p)) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * PER_ITER);
+    } else {
+        size_t bad = 0;
+        for (auto _ : state) {
+            for (int i = 0; i < PER_ITER; ++i) {
+                void* p;
+                while (!mpmc_queue.try_pop(p)) {
+                    std::this_thread::yield();
+                }
+                bad += *static_cast<size_t*>(p) != size;
+                A::deallocate(p, size);
+            }
+        }
+        if (bad) state.SkipWithError("payload corrupted");
+        if (state.thread_index() == 1) report_spans<A>(state);
+    }
+}
+BENCHMARK_TEMPLATE(BM_MpmcHandoff, Malloc)->Threads(2)->Threads(4)->Arg(32)->Arg(256)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MpmcHandoff, Small)->Threads(2)->Threads(4)->Arg(32)->Arg(256)->UseRealTime();
+
+TOPO_BENCHMARK_MAIN();
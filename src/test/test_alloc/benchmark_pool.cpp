@@ -0,0 +1,149 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "BenchPin.h"
+#include "MpmcRingBuffer.h"
+#include "ObjectPool.h"
+#include "SpscRingBuffer.h"
+
+// 大消息经过队列的三种传法：
+//   value    消息本身放进槽位，入队拷一次、出队再拷一次
+//   malloc   生产者 new、消费者 delete，队列里放指针
+//   pool     生产者从 ObjectPool 取、消费者还回去，队列里放 4 字节句柄
+// 生产者每条消息都写满负载，消费者检查首尾字节，三种传法做的"有用功"相同
+
+template<size_t N>
+struct Message {
+    uint64_t seq;
+    char body[N - sizeof(uint64_t)];
+};
+
+template<size_t N>
+static void fill(Message<N>& m, uint64_t seq) {
+    m.seq = seq;
+    memset(m.body, char(seq), sizeof(m.body));
+}
+
+template<size_t N>
+static bool check(const Message<N>& m) {
+    return m.body[0] == char(m.seq) && m.body[sizeof(m.body) - 1] == char(m.seq);
+}
+
+template<size_t N>
+struct ByValue {
+    using Payload = Message<N>;
+    static bool make(Payload& out, uint64_t seq) {
+        fill(out, seq);
+        return true;
+    }
+    static bool consume(Payload& p) { return check(p); }
+};
+
+template<size_t N>
+struct ByMalloc {
+    using Payload = Message<N>*;
+    static bool make(Payload& out, uint64_t seq) {
+        out = new Message<N>;
+        fill(*out, seq);
+        return true;
+    }
+    static bool consume(Payload p) {
+        bool ok = check(*p);
+        delete p;
+        return ok;
+    }
+};
+
+// 池要装得下队列里的全部消息加上各线程手里的，按队列容量的两倍取
+static constexpr size_t RING_SIZE = 1024;
+
+template<size_t N>
+struct ByPool {
+    using Payload = uint32_t;
+    static alloc::ObjectPool<Message<N>>& pool() {
+        static alloc::ObjectPool<Message<N>> p(2 * RING_SIZE);
+        return p;
+    }
+    static bool make(Payload& out, uint64_t seq) {
+        out = pool().emplace();
+        if (out == alloc::ObjectPool<Message<N>>::NIL) return false;
+        fill(pool()[out], seq);
+        return true;
+    }
+    static bool consume(Payload h) {
+        bool ok = check(pool()[h]);
+        pool().release(h);
+        return ok;
+    }
+};
+
+static constexpr int PER_ITER = 64;
+
+// 偶数线程生产、奇数线程消费；SPSC 只跑两个线程
+template<template<typename, size_t> class Ring, typename Mode, size_t N>
+static void BM_Transfer(benchmark::State& state) {
+    static Ring<typename Mode::Payload, RING_SIZE> ring;
+    auto pinned = topo::pin(state);
+    if ((state.thread_index() & 1) == 0) {
+        uint64_t seq = 0;
+        for (auto _ : state) {
+            for (int i = 0; i < PER_ITER; ++i) {
+                typename Mode::Payload p;
+                while (!Mode::make(p, seq)) {
+                    std::this_thread::yield();
+                }
+                ++seq;
+                while (!ring.try_emplace(p)) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * PER_ITER);
+        state.SetBytesProcessed(state.iterations() * PER_ITER * N);
+    } else {
+        size_t bad = 0;
+        for (auto _ : state) {
+            for (int i = 0; i < PER_ITER; ++i) {
+                typename Mode::Payload p;
+                while (!ring.try_pop(p)) {
+                    std::this_thread::yield();
+                }
+                bad += !Mode::consume(p);
+            }
+        }
+        if (bad) state.SkipWithError("payload corrupted");
+    }
+}
+
+template<size_t N>
+static void register_size() {
+    const std::string size = "/" + std::to_string(N);
+    auto spsc = [&](const char* mode, auto fn) {
+        benchmark::RegisterBenchmark(("BM_Transfer/spsc/" + std::string(mode) + size).c_str(), fn)
+            ->Threads(2)
+            ->UseRealTime();
+    };
+    auto mpmc = [&](const char* mode, auto fn) {
+        benchmark::RegisterBenchmark(("BM_Transfer/mpmc/" + std::string(mode) + size).c_str(), fn)
+            ->Threads(2)
+            ->Threads(4)
+            ->UseRealTime();
+    };
+    spsc("value", BM_Transfer<SpscRingBuffer, ByValue<N>, N>);
+    spsc("malloc", BM_Transfer<SpscRingBuffer, ByMalloc<N>, N>);
+    spsc("pool", BM_Transfer<SpscRingBuffer, ByPool<N>, N>);
+    mpmc("value", BM_Transfer<MpmcRingBuffer, ByValue<N>, N>);
+    mpmc("malloc", BM_Transfer<MpmcRingBuffer, ByMalloc<N>, N>);
+    mpmc("pool", BM_Transfer<MpmcRingBuffer, ByPool<N>, N>);
+}
+
+static const bool registered = [] {
+    register_size<256>();
+    register_size<4096>();
+    return true;
+}();
@@ -0,0 +1,108 @@
+#include <benchmark/benchmark.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include "BenchCounters.h"
+#include "BenchPin.h"
+#include "Log.h"
+
+// 调用线程上一条日志的代价：服务程序里那种"一个整数 + 一小段请求内容"。
+//   printf  行缓冲的 FILE，和输出到终端时一样每行一次 write，stdio 锁在线程间共享
+//   alog    记录进本线程的环，后台线程写到 /dev/null。drop 时后台线程跟不上就丢（计数），
+//           block 时等后台线程，测的是后台线程的吞吐
+
+static const int MAX_LOG_THREADS = std::max(2u, topo::default_threads());
+
+static constexpr std::string_view REQUEST = "GET /index.html HTTP/1.1";
+
+// 后台线程格式化出来的内容和 printf 一致（长度修饰符省略、* 宽度、字符串截断）
+static bool format_check() {
+    const int fd = memfd_create("alog_check", 0);
+    if (fd < 0) return false;
+    alog::start({fd, alog::Overflow::Block});
+    ALOG("fd=%d req=%.*s %5.2f %x %s %c%%", -7, 3, REQUEST, 1.5, 255u, "tail", 'z');
+    ALOG("missing %d %d", 1);
+    alog::stop();
+    std::string text(4096, '\0');
+    text.resize(size_t(std::max<ssize_t>(pread(fd, text.data(), text.size(), 0), 0)));
+    close(fd);
+    return text.find("] fd=-7 req=GET  1.50 ff tail z%\n") != std::string::npos &&
+           text.find("] missing 1 <?>\n") != std::string::npos;
+}
+
+static void BM_Printf(benchmark::State& state) {
+    static FILE* sink = [] {
+        FILE* f = fopen("/dev/null", "w");
+        setvbuf(f, nullptr, _IOLBF, 4096);
+        return f;
+    }();
+    auto pinned = topo::pin(state);
+    perf::BenchCounters perf_counters(state);
+    int fd = state.thread_index();
+    for (auto _ : state) {
+        fprintf(sink, "read from fd=%d: %.*s\n", fd, int(REQUEST.size()), REQUEST.data());
+        ++fd;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Printf)->ThreadRange(1, MAX_LOG_THREADS);
+
+template<alog::Overflow Policy>
+static void BM_Alog(benchmark::State& state) {
+    static const int devnull = open("/dev/null", O_WRONLY);
+    uint64_t dropped_before = 0;
+    if (state.thread_index() == 0) {
+        if (!format_check()) {
+            state.SkipWithError("formatted output differs from printf");
+        }
+        alog::start({devnull, Policy});
+        dropped_before = alog::dropped();
+    }
+    auto pinned = topo::pin(state);
+    perf::BenchCounters perf_counters(state);
+    int fd = state.thread_index();
+    for (auto _ : state) {
+        ALOG("read from fd=%d: %s", fd, REQUEST);
+        ++fd;
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        alog::stop();
+        state.counters["dropped"] = double(alog::dropped() - dropped_before);
+    }
+}
+BENCHMARK_TEMPLATE(BM_Alog, alog::Overflow::Drop)->ThreadRange(1, MAX_LOG_THREADS);
+BENCHMARK_TEMPLATE(BM_Alog, alog::Overflow::Block)->ThreadRange(1, MAX_LOG_THREADS);
+
+// 只量进环：每次迭代写一批不超过环容量的记录，计时外等后台线程取空。
+// 核少的机器上后台线程和调用线程抢同一个核，上面的 drop 几乎全丢，量到的是丢弃路径
+static constexpr int BURST = 256;
+static void BM_AlogBurst(benchmark::State& state) {
+    static const int devnull = open("/dev/null", O_WRONLY);
+    alog::start({devnull, alog::Overflow::Drop});
+    const uint64_t dropped_before = alog::dropped();
+    perf::BenchCounters perf_counters(state);
+    int fd = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < BURST; ++i) {
+            ALOG("read from fd=%d: %s", fd, REQUEST);
+            ++fd;
+        }
+        state.PauseTiming();
+        alog::flush();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * BURST);
+    alog::stop();
+    state.counters["dropped"] = double(alog::dropped() - dropped_before);
+}
+BENCHMARK(BM_AlogBurst);
+
+TOPO_BENCHMARK_MAIN();
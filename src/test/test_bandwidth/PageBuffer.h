@@ -0,0 +1,70 @@
+#ifndef __TEST_BANDWIDTH_PAGEBUFFER__
+#define __TEST_BANDWIDTH_PAGEBUFFER__
+#include <sys/mman.h>
+
+#include <cstddef>
+#include <cstring>
+#include <utility>
+
+// 用 mmap 直接申请、可以指定页大小的缓冲区
+enum class PageMode {
+    Small,    // 4K 页，并用 MADV_NOHUGEPAGE 禁掉透明大页
+    THP,      // madvise(MADV_HUGEPAGE)，由内核尽量换成 2M 透明大页
+    HugeTLB,  // MAP_HUGETLB，预留的 2M 大页；没有预留（vm.nr_hugepages == 0）时申请失败
+};
+
+inline const char* page_mode_name(PageMode mode) {
+    switch (mode) {
+        case PageMode::Small: return "4k";
+        case PageMode::THP: return "thp";
+        case PageMode::HugeTLB: return "hugetlb";
+    }
+    return "?";
+}
+
+class PageBuffer {
+public:
+    static constexpr size_t HUGE_PAGE = 2 << 20;
+
+    PageBuffer() = default;
+
+    // 申请后立即逐页写一遍，计时循环里不会再有缺页；失败时 data() 为 nullptr
+    PageBuffer(size_t bytes, PageMode mode) {
+        size_ = (bytes + HUGE_PAGE - 1) & ~(HUGE_PAGE - 1);
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+        if (mode == PageMode::HugeTLB) flags |= MAP_HUGETLB;
+        void* p = mmap(nullptr, size_, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (p == MAP_FAILED) {
+            size_ = 0;
+            return;
+        }
+        if (mode == PageMode::Small) madvise(p, size_, MADV_NOHUGEPAGE);
+        if (mode == PageMode::THP) madvise(p, size_, MADV_HUGEPAGE);
+        data_ = static_cast<char*>(p);
+        memset(data_, 1, size_);
+    }
+
+    ~PageBuffer() {
+        if (data_) munmap(data_, size_);
+    }
+
+    PageBuffer(PageBuffer&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+    PageBuffer& operator=(PageBuffer&& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        return *this;
+    }
+
+    template<typename T = char>
+    T* data() const {
+        return reinterpret_cast<T*>(data_);
+    }
+    size_t size() const { return size_; }
+
+private:
+    char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+#endif /* __TEST_BANDWIDTH_PAGEBUFFER__ */
@@ -0,0 +1,122 @@
+#include <benchmark/benchmark.h>
+#include <bit>
+#include <cstdint>
+
+#include "PageBuffer.h"
+#include "StreamKernels.h"
+
+// ────────────────────────────────────────────────
+//  内存带宽：读 / 写 / 拷贝 / triad，工作集从 L1 扫到 DRAM
+//  state.range(0) 为每个数组的字节数；bytes_per_second 按实际搬运的字节算
+//  （拷贝 2 份、triad 3 份，普通写的 RFO 读不计入）
+// ────────────────────────────────────────────────
+
+// 和 test_sum 的 data 一样大：1e8 个 int
+constexpr size_t DATA_BYTES = size_t(1e8) * sizeof(int);
+
+static void working_set_sweep(benchmark::internal::Benchmark* b) {
+    b->RangeMultiplier(4)->Range(16 << 10, 256 << 20);
+}
+
+static void BM_Read(benchmark::State& state) {
+    const size_t bytes = state.range(0);
+    PageBuffer buf(bytes, PageMode::THP);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(stream::read(buf.data(), bytes));
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_Read)->Apply(working_set_sweep);
+
+template<bool NonTemporal>
+static void BM_Write(benchmark::State& state) {
+    const size_t bytes = state.range(0);
+    PageBuffer buf(bytes, PageMode::THP);
+    for (auto _ : state) {
+        stream::write<NonTemporal>(buf.data(), bytes, state.iterations());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK_TEMPLATE(BM_Write, false)->Apply(working_set_sweep);
+BENCHMARK_TEMPLATE(BM_Write, true)->Apply(working_set_sweep);
+
+template<bool NonTemporal>
+static void BM_Copy(benchmark::State& state) {
+    const size_t bytes = state.range(0);
+    PageBuffer src(bytes, PageMode::THP), dst(bytes, PageMode::THP);
+    for (auto _ : state) {
+        stream::copy<NonTemporal>(dst.data(), src.data(), bytes);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * bytes * 2);
+}
+BENCHMARK_TEMPLATE(BM_Copy, false)->Apply(working_set_sweep);
+BENCHMARK_TEMPLATE(BM_Copy, true)->Apply(working_set_sweep);
+
+template<bool NonTemporal>
+static void BM_Triad(benchmark::State& state) {
+    const size_t bytes = state.range(0);
+    const size_t n = bytes / sizeof(double);
+    PageBuffer a(bytes, PageMode::THP), b(bytes, PageMode::THP), c(bytes, PageMode::THP);
+    for (auto _ : state) {
+        stream::triad<NonTemporal>(a.data<double>(), b.data<double>(), c.data<double>(), n, 3.0);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * bytes * 3);
+    state.counters["flops"] = benchmark::Counter(double(state.iterations()) * n * 2, benchmark::Counter::kIsRate);
+}
+BENCHMARK_TEMPLATE(BM_Triad, false)->Apply(working_set_sweep);
+BENCHMARK_TEMPLATE(BM_Triad, true)->Apply(working_set_sweep);
+
+// ────────────────────────────────────────────────
+//  软件预取距离：DRAM 大小的顺序读，state.range(0) 为提前的字节数，0 表示不预取
+// ────────────────────────────────────────────────
+static void BM_Read_Prefetch(benchmark::State& state) {
+    const size_t bytes = 256 << 20;
+    const size_t distance = state.range(0);
+    // 多留一段，预取不会越过映射区
+    PageBuffer buf(bytes + distance, PageMode::THP);
+    for (auto _ : state) {
+        if (distance == 0) {
+            benchmark::DoNotOptimize(stream::read(buf.data(), bytes));
+        } else {
+            benchmark::DoNotOptimize(stream::read<true>(buf.data(), bytes, distance));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_Read_Prefetch)->Arg(0)->Arg(64)->Arg(256)->Arg(1024)->Arg(4096)->Arg(16384);
+
+// ────────────────────────────────────────────────
+//  页大小：data 大小的数组分别用 4K / 透明大页 / hugetlbfs 大页
+//  顺序读主要看硬件预取，随机读才会把 TLB 缺失暴露出来
+// ────────────────────────────────────────────────
+static PageMode page_mode(benchmark::State& state) {
+    return static_cast<PageMode>(state.range(0));
+}
+
+static void BM_Read_PageSize(benchmark::State& state) {
+    PageBuffer buf(DATA_BYTES, page_mode(state));
+    if (!buf.data()) return state.SkipWithError("mmap failed (no hugetlb pages reserved?)");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(stream::read(buf.data(), DATA_BYTES & ~(stream::LINE - 1)));
+    }
+    state.SetBytesProcessed(state.iterations() * DATA_BYTES);
+    state.SetLabel(page_mode_name(page_mode(state)));
+}
+BENCHMARK(BM_Read_PageSize)->DenseRange(0, 2);
+
+static void BM_RandomRead_PageSize(benchmark::State& state) {
+    // 随机下标要求 2 的幂，取不超过 DATA_BYTES 的最大值
+    const size_t bytes = std::bit_floor(DATA_BYTES);
+    const size_t lines = 1 << 22;
+    PageBuffer buf(bytes, page_mode(state));
+    if (!buf.data()) return state.SkipWithError("mmap failed (no hugetlb pages reserved?)");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(stream::random_read(buf.data(), bytes, lines));
+    }
+    state.SetItemsProcessed(state.iterations() * lines);
+    state.SetLabel(page_mode_name(page_mode(state)));
+}
+BENCHMARK(BM_RandomRead_PageSize)->DenseRange(0, 2);
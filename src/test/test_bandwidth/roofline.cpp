@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include "BenchPin.h"
+#include "PageBuffer.h"
+#include "StreamKernels.h"
+
+// ────────────────────────────────────────────────
+//  简易 roofline：跑完所有基准后实测算力峰值和 L1 / DRAM 读带宽，
+//  给出常见内核的算术强度（每字节操作数）和据此能达到的上限，
+//  用来判断 test_sum 里的内核是卡在访存还是卡在计算
+// ────────────────────────────────────────────────
+
+namespace {
+
+// 对 bytes 大小的缓冲区反复顺序读，取最好的一次，GB/s
+double best_read_gbps(size_t bytes, int reps) {
+    PageBuffer buf(bytes, PageMode::THP);
+    size_t passes = std::max<size_t>(1, (64 << 20) / bytes);
+    double best = 0;
+    for (int r = 0; r < reps; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < passes; ++i) {
+            benchmark::DoNotOptimize(stream::read(buf.data(), bytes));
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = std::max(best, double(bytes) * passes / ns);
+    }
+    return best;
+}
+
+struct KernelIntensity {
+    const char* name;
+    double ops_per_byte;
+};
+
+// 只数真正的运算（加法 / 比较 / 乘加），不数 load
+constexpr KernelIntensity KERNELS[] = {
+    {"sum int32", 1.0 / 4},
+    {"sum int64 / double", 1.0 / 8},
+    {"minmax int32", 2.0 / 4},
+    {"filter_gt int32", 1.0 / 8},  // 读 + 写
+    {"inclusive_scan int32", 3.0 / 8},
+    {"triad double", 2.0 / 24},
+};
+
+void print_roofline() {
+    double l1 = best_read_gbps(16 << 10, 5);
+    double dram = best_read_gbps(256 << 20, 3);
+    double gops = stream::peak_int32_gops_sse2();
+    const char* compute_isa = "sse2";
+    if (__builtin_cpu_supports("avx2")) {
+        gops = std::max(gops, stream::peak_int32_gops_avx2());
+        compute_isa = "avx2";
+    }
+
+    printf("\nroofline (single thread)\n");
+    printf("  peak compute   %8.1f Gop/s (int32 add, %s)\n", gops, compute_isa);
+    printf("  L1 read        %8.1f GB/s   ridge %.2f op/B\n", l1, gops / l1);
+    printf("  DRAM read      %8.1f GB/s   ridge %.2f op/B\n", dram, gops / dram);
+    printf("  %-22s %8s %14s %14s\n", "kernel", "op/B", "L1 Gop/s", "DRAM Gop/s");
+    for (const auto& k : KERNELS) {
+        double at_l1 = std::min(gops, k.ops_per_byte * l1);
+        double at_dram = std::min(gops, k.ops_per_byte * dram);
+        printf("  %-22s %8.3f %9.1f (%s) %9.1f (%s)\n", k.name, k.ops_per_byte, at_l1,
+               at_l1 < gops ? "mem" : "cpu", at_dram, at_dram < gops ? "mem" : "cpu");
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    topo::initialize(argc, argv);
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    ::benchmark::RunSpecifiedBenchmarks();
+    print_roofline();
+    ::benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "BenchPin.h"
+#include "Channel.h"
+#include "Reactor.h"
+
+constexpr size_t testSize = 1e6;
+
+// ────────────────────────────────────────────────
+//  多个计算线程 → 一个 reactor 上的协程（批量接收）
+// ────────────────────────────────────────────────
+
+Task batch_consumer(Reactor& reactor, MpmcChannel<uint64_t, (1 << 12)>& ch, size_t total, uint64_t& sum) {
+    std::vector<uint64_t> batch;
+    batch.reserve(1 << 12);
+    size_t received = 0;
+    while (received < total) {
+        batch.clear();
+        received += co_await ch.recv_batch(batch);
+        for (auto v : batch) {
+            sum += v;
+        }
+    }
+    reactor.stop();
+}
+
+static void BM_MpmcChannel_ThreadsToCoroutine(benchmark::State& state) {
+    const int producers = state.range(0);
+    for (auto _ : state) {
+        MpmcChannel<uint64_t, (1 << 12)> ch;
+        uint64_t sum = 0;
+
+        std::thread reactor_thread([&] {
+            topo::pin_current(0, producers + 1);
+            Reactor reactor;
+            Task consumer = batch_consumer(reactor, ch, testSize * producers, sum);
+            reactor.run();
+        });
+
+        std::vector<std::thread> workers;
+        for (int p = 0; p < producers; ++p) {
+            workers.emplace_back([&, p] {
+                topo::pin_current(p + 1, producers + 1);
+                for (size_t i = 0; i < testSize; ++i) {
+                    ch.send_blocking(1);
+                }
+            });
+        }
+        for (auto& t : workers) {
+            t.join();
+        }
+        reactor_thread.join();
+
+        if (sum != testSize * producers) state.SkipWithError("lost messages");
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * testSize * producers);
+}
+BENCHMARK(BM_MpmcChannel_ThreadsToCoroutine)->Arg(1)->Arg(2)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// ────────────────────────────────────────────────
+//  线程 ↔ 协程 乒乓：每条消息都要挂起 / 唤醒一次，衡量往返延迟
+// ────────────────────────────────────────────────
+
+constexpr size_t pingPongRounds = 1e5;
+
+Task echo_coroutine(Reactor& reactor, SpscChannel<uint64_t, 16>& in, SpscChannel<uint64_t, 16>& out) {
+    for (size_t i = 0; i < pingPongRounds; ++i) {
+        uint64_t v = co_await in.recv();
+        co_await out.send(v + 1);
+    }
+    reactor.stop();
+}
+
+static void BM_SpscChannel_PingPong(benchmark::State& state) {
+    // 主线程当客户端，只在这个基准里绑
+    topo::ScopedPin pinned(1, 2);
+    for (auto _ : state) {
+        SpscChannel<uint64_t, 16> ping;
+        SpscChannel<uint64_t, 16> pong;
+
+        std::thread reactor_thread([&] {
+            topo::pin_current(0, 2);
+            Reactor reactor;
+            Task echo = echo_coroutine(reactor, ping, pong);
+            reactor.run();
+        });
+
+        uint64_t v = 0;
+        for (size_t i = 0; i < pingPongRounds; ++i) {
+            ping.send_blocking(v);
+            v = pong.recv_blocking();
+        }
+        reactor_thread.join();
+
+        if (v != pingPongRounds) state.SkipWithError("unexpected echo value");
+    }
+    state.SetItemsProcessed(state.iterations() * pingPongRounds);
+}
+BENCHMARK(BM_SpscChannel_PingPong)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+TOPO_BENCHMARK_MAIN();
@@ -0,0 +1,113 @@
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "Reactor.h"
+#include "Topology.h"
+
+// ────────────────────────────────────────────────
+//  跨线程切换延迟：协程在两个 reactor 之间来回跳，每一跳都是一次 post + eventfd 唤醒
+// ────────────────────────────────────────────────
+
+constexpr size_t hopRounds = 1e5;
+
+Task ping_pong(Reactor& a, Reactor& b, size_t rounds) {
+    for (size_t i = 0; i < rounds; ++i) {
+        co_await b.schedule_from_any_thread();
+        co_await a.schedule_from_any_thread();
+    }
+    a.stop();
+    b.stop();
+}
+
+static void BM_Reactor_CrossThreadHop(benchmark::State& state) {
+    size_t wakeups = 0;
+    std::chrono::nanoseconds elapsed{0};
+    for (auto _ : state) {
+        const auto start = std::chrono::steady_clock::now();
+        Reactor a;
+        Reactor b;
+        // 两个 reactor 线程按 --pin 策略成对绑核，llc-pairs / split-pairs 下就是同 LLC / 跨 LLC 的一跳
+        std::thread tb([&] {
+            topo::pin_current(0, 2);
+            b.run();
+        });
+        std::thread ta([&] {
+            topo::pin_current(1, 2);
+            Task t = ping_pong(a, b, hopRounds);
+            a.run();
+            // b 停止之后才能销毁协程帧
+            tb.join();
+        });
+        ta.join();
+        elapsed += std::chrono::steady_clock::now() - start;
+        wakeups += a.wakeup_writes() + b.wakeup_writes();
+    }
+    // 每次往返两跳
+    state.SetItemsProcessed(state.iterations() * hopRounds * 2);
+    state.counters["ns_per_hop"] = double(elapsed.count()) / double(state.iterations() * hopRounds * 2);
+    state.counters["wakeups"] = benchmark::Counter(wakeups, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Reactor_CrossThreadHop)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// ────────────────────────────────────────────────
+//  多线程向一个 reactor 注入：吞吐 + 合并后实际的 eventfd 写次数
+// ────────────────────────────────────────────────
+
+constexpr size_t postsPerThread = 1e6;
+
+// 每被恢复一次计数一次，然后原地挂起等下一次 post
+Task counter(size_t& resumed) {
+    while (true) {
+        co_await std::suspend_always{};
+        ++resumed;
+    }
+}
+
+static void BM_Reactor_PostFromThreads(benchmark::State& state) {
+    const int producers = state.range(0);
+    size_t wakeups = 0;
+    for (auto _ : state) {
+        Reactor reactor;
+        size_t resumed = 0;
+        Task c = counter(resumed);
+        const size_t total = postsPerThread * producers;
+
+        std::thread rt([&] {
+            topo::pin_current(0, producers + 1);
+            reactor.run();
+        });
+        std::vector<std::thread> workers;
+        for (int p = 0; p < producers; ++p) {
+            workers.emplace_back([&, p] {
+                topo::pin_current(p + 1, producers + 1);
+                for (size_t i = 0; i < postsPerThread; ++i) {
+                    reactor.post(c.h);
+                }
+            });
+        }
+        for (auto& t : workers) {
+            t.join();
+        }
+        // 收尾协程排在所有 post 之后，确认全部恢复后停止 reactor
+        Task stopper = [](Reactor& r, size_t& n, size_t expect) -> Task {
+            co_await r.schedule_from_any_thread();
+            while (n < expect) {
+                co_await r.schedule_from_any_thread();
+            }
+            r.stop();
+        }(reactor, resumed, total);
+        rt.join();
+
+        wakeups += reactor.wakeup_writes();
+    }
+    state.SetItemsProcessed(state.iterations() * postsPerThread * producers);
+    state.counters["wakeups"] = benchmark::Counter(wakeups, benchmark::Counter::kIsRate);
+    state.counters["posts_per_wakeup"] =
+        benchmark::Counter(double(state.iterations() * postsPerThread * producers) / (wakeups ? wakeups : 1));
+}
+BENCHMARK(BM_Reactor_PostFromThreads)->Arg(1)->Arg(2)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
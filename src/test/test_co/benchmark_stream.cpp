@@ -0,0 +1,88 @@
+#include <benchmark/benchmark.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "AsyncStream.h"
+#include "BenchHistogram.h"
+#include "Reactor.h"
+#include "Topology.h"
+#include "Tsc.h"
+
+// ────────────────────────────────────────────────
+//  长度前缀帧的流水线回显：客户端一次写入 batch 个请求，
+//  服务端协程逐帧取出（零拷贝）并排队回写，每批只有一次 writev
+// ────────────────────────────────────────────────
+
+constexpr size_t messageCount = 2e5;
+constexpr size_t payloadSize = 64;
+
+Task framed_echo(Reactor& reactor, int fd) {
+    AsyncStream stream(reactor, fd);
+    LengthPrefixedFramer framer(stream);
+    while (auto frame = co_await framer.next()) {
+        framer.send(*frame);
+    }
+    co_await stream.flush();
+    reactor.stop();
+}
+
+// 客户端看到的每批往返时间：写出一批请求到收齐全部回应
+static stats::Histogram echoRoundTrip;
+
+static void BM_Stream_PipelinedEcho(benchmark::State& state) {
+    // 主线程当客户端，和服务端线程按 --pin 策略成对绑核
+    topo::ScopedPin pinned(1, 2);
+    const size_t batch = state.range(0);
+
+    std::string request;
+    for (size_t i = 0; i < batch; ++i) {
+        uint32_t len = payloadSize;
+        char hdr[4] = {char(len >> 24), char(len >> 16), char(len >> 8), char(len)};
+        request.append(hdr, 4);
+        request.append(payloadSize, 'x');
+    }
+    std::string response(request.size(), '\0');
+
+    echoRoundTrip.reset();
+    for (auto _ : state) {
+        int fds[2];
+        socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+        fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+
+        std::thread server([&] {
+            topo::pin_current(0, 2);
+            Reactor reactor;
+            Task echo = framed_echo(reactor, fds[1]);
+            reactor.run();
+        });
+
+        bool ok = true;
+        for (size_t sent = 0; sent < messageCount; sent += batch) {
+            const uint64_t start = stats::tsc_now();
+            if (write(fds[0], request.data(), request.size()) != ssize_t(request.size())) ok = false;
+            size_t got = 0;
+            while (got < response.size()) {
+                ssize_t r = read(fds[0], response.data() + got, response.size() - got);
+                if (r <= 0) {
+                    ok = false;
+                    break;
+                }
+                got += r;
+            }
+            echoRoundTrip.record(stats::tsc_now() - start);
+        }
+        shutdown(fds[0], SHUT_WR);
+        server.join();
+        close(fds[0]);
+
+        if (!ok || response != request) state.SkipWithError("echo mismatch");
+    }
+    state.SetItemsProcessed(state.iterations() * (messageCount / batch) * batch);
+    stats::report(state, echoRoundTrip.snapshot(), "stream_echo_" + std::to_string(batch), stats::tsc_per_ns());
+}
+BENCHMARK(BM_Stream_PipelinedEcho)->Arg(1)->Arg(16)->Arg(128)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+
+#include "BenchCounters.h"
+#include "BenchPin.h"
+#include "RcuPtr.h"
+#include "Seqlock.h"
+
+// ────────────────────────────────────────────────
+//  Part 4: 读多写少的共享状态：shared_mutex vs Seqlock vs RcuPtr
+//  每次迭代读一份 64 字节的快照，看 1 ~ N 个读线程下每次读的代价。
+//  shared_lock 即使没有写者，每个读者也要改锁里的读者计数，那个缓存行在核之间来回跳；
+//  Seqlock / RcuPtr 的读者不写共享的缓存行
+// ────────────────────────────────────────────────
+
+static const int MAX_READ_THREADS = std::max(2u, topo::default_threads());
+
+// 所有字段都等于版本号，读到的字段不一致就是撕裂的快照
+struct Config {
+    uint64_t fields[8];
+};
+
+static Config make_config(uint64_t version) {
+    Config c;
+    std::fill(std::begin(c.fields), std::end(c.fields), version);
+    return c;
+}
+
+static bool consistent(const Config& c) {
+    return std::all_of(std::begin(c.fields), std::end(c.fields), [&](uint64_t f) { return f == c.fields[0]; });
+}
+
+// WithWriter：线程 0 每 1024 次迭代发布一次新版本，其余时间和别的线程一样在读
+static constexpr uint64_t WRITE_EVERY = 1024;
+
+static bool writes_now(const benchmark::State& state, uint64_t i) {
+    return state.range(0) && state.thread_index() == 0 && i % WRITE_EVERY == WRITE_EVERY - 1;
+}
+
+static Config locked_config = make_config(0);
+static std::shared_mutex config_mu;
+static void BM_Read_SharedMutex(benchmark::State& state) {
+    auto pinned = topo::pin(state);
+    perf::BenchCounters perf_counters(state);
+    uint64_t i = 0, bad = 0;
+    for (auto _ : state) {
+        if (writes_now(state, i++)) {
+            std::unique_lock lock(config_mu);
+            locked_config = make_config(locked_config.fields[0] + 1);
+        }
+        std::shared_lock lock(config_mu);
+        bad += !consistent(locked_config);
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (bad) state.SkipWithError("torn snapshot");
+}
+
+static rcu::Seqlock<Config> seqlock_config(make_config(0));
+static void BM_Read_Seqlock(benchmark::State& state) {
+    auto pinned = topo::pin(state);
+    perf::BenchCounters perf_counters(state);
+    uint64_t i = 0, bad = 0;
+    for (auto _ : state) {
+        if (writes_now(state, i++)) {
+            seqlock_config.update([](Config& c) { c = make_config(c.fields[0] + 1); });
+        }
+        Config c = seqlock_config.load();
+        bad += !consistent(c);
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (bad) state.SkipWithError("torn snapshot");
+}
+
+static rcu::RcuPtr<Config> rcu_config(std::make_unique<Config>(make_config(0)));
+static void BM_Read_Rcu(benchmark::State& state) {
+    auto pinned = topo::pin(state);
+    perf::BenchCounters perf_counters(state);
+    uint64_t i = 0, bad = 0;
+    for (auto _ : state) {
+        if (writes_now(state, i++)) {
+            rcu_config.modify([](Config& c) { c = make_config(c.fields[0] + 1); });
+        }
+        auto r = rcu_config.read();
+        bad += !consistent(*r);
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (bad) state.SkipWithError("torn snapshot");
+}
+
+// Arg(0) 只读，Arg(1) 带一个写者
+BENCHMARK(BM_Read_SharedMutex)->ArgName("writer")->Arg(0)->Arg(1)->ThreadRange(1, MAX_READ_THREADS);
+BENCHMARK(BM_Read_Seqlock)->ArgName("writer")->Arg(0)->Arg(1)->ThreadRange(1, MAX_READ_THREADS);
+BENCHMARK(BM_Read_Rcu)->ArgName("writer")->Arg(0)->Arg(1)->ThreadRange(1, MAX_READ_THREADS);
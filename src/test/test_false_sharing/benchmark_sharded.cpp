@@ -0,0 +1,133 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "BenchCounters.h"
+#include "BenchPin.h"
+#include "ShardedCounter.h"
+
+// ────────────────────────────────────────────────
+//  Part 3: 可复用的分片计数器 vs 单个原子变量 / 填充数组 / thread_local
+//  每次迭代加一次，看 1 ~ N 个线程下每次自增的代价
+// ────────────────────────────────────────────────
+
+static const int MAX_COUNTER_THREADS = std::max(2u, topo::default_threads());
+
+static std::atomic<int64_t> single_counter{0};
+static void BM_Counter_SingleAtomic(benchmark::State& state) {
+    auto pinned = topo::pin(state);
+    perf::BenchCounters perf_counters(state);
+    for (auto _ : state) {
+        single_counter.fetch_add(1, std::memory_order_relaxed);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Counter_SingleAtomic)->ThreadRange(1, MAX_COUNTER_THREADS);
+
+// 和 Padder 一样按 thread_index 分开，但下标要事先知道，读的一方也得知道有多少个
+struct alignas(stats::CACHE_LINE) PaddedAtomic {
+    std::atomic<int64_t> value{0};
+};
+static std::vector<PaddedAtomic> padded_counters(MAX_COUNTER_THREADS);
+static void BM_Counter_PaddedArray(benchmark::State& state) {
+    auto pinned = topo::pin(state);
+    auto& cnt = padded_counters[state.thread_index()].value;
+    perf::BenchCounters perf_counters(state);
+    for (auto _ : state) {
+        cnt.fetch_add(1, std::memory_order_relaxed);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Counter_PaddedArray)->ThreadRange(1, MAX_COUNTER_THREADS);
+
+// 下限：普通的线程局部自增，但别的线程根本读不到
+thread_local int64_t local_counter = 0;
+static void BM_Counter_ThreadLocal(benchmark::State& state) {
+    auto pinned = topo::pin(state);
+    perf::BenchCounters perf_counters(state);
+    for (auto _ : state) {
+        ++local_counter;
+        benchmark::DoNotOptimize(local_counter);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Counter_ThreadLocal)->ThreadRange(1, MAX_COUNTER_THREADS);
+
+static stats::ShardedCounter sharded_counter;
+static void BM_Counter_Sharded(benchmark::State& state) {
+    auto pinned = topo::pin(state);
+    perf::BenchCounters perf_counters(state);
+    for (auto _ : state) {
+        sharded_counter.inc();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Counter_Sharded)->ThreadRange(1, MAX_COUNTER_THREADS);
+
+// 同一个 gauge 上每个线程 +1 再 -1
+static stats::ShardedGauge sharded_gauge;
+static void BM_Gauge_Sharded(benchmark::State& state) {
+    auto pinned = topo::pin(state);
+    perf::BenchCounters perf_counters(state);
+    for (auto _ : state) {
+        sharded_gauge.inc();
+        sharded_gauge.dec();
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_Gauge_Sharded)->ThreadRange(1, MAX_COUNTER_THREADS);
+
+// 一个读者持续聚合，其余线程写：读者每次要扫一遍所有分片
+static stats::ShardedCounter read_counter;
+static void BM_Counter_ShardedWithReader(benchmark::State& state) {
+    auto pinned = topo::pin(state);
+    if (state.thread_index() == 0) {
+        uint64_t last = 0;
+        perf::BenchCounters perf_counters(state);
+        for (auto _ : state) {
+            last = read_counter.value();
+            benchmark::DoNotOptimize(last);
+        }
+        state.SetLabel("thread 0 reads");
+    } else {
+        perf::BenchCounters perf_counters(state);
+        for (auto _ : state) {
+            read_counter.inc();
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+}
+BENCHMARK(BM_Counter_ShardedWithReader)->ThreadRange(2, MAX_COUNTER_THREADS);
+
+// 反复创建、退出线程：槽位要被复用，分片数不随线程总数增长；顺便核对总和
+static void BM_Counter_ThreadChurn(benchmark::State& state) {
+    const int threads = state.range(0);
+    constexpr int ADDS = 1000;
+    stats::ShardedCounter counter;
+    stats::ShardedGauge gauge;
+    uint64_t expect = 0;
+    perf::BenchCounters perf_counters(state);
+    for (auto _ : state) {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&] {
+                gauge.inc();
+                for (int i = 0; i < ADDS; ++i) {
+                    counter.inc();
+                }
+                gauge.dec();
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+        expect += uint64_t(threads) * ADDS;
+    }
+    if (counter.value() != expect || gauge.value() != 0) return state.SkipWithError("sharded total mismatch");
+    state.counters["slots"] = stats::ShardSlots::high_water();
+    state.SetItemsProcessed(state.iterations() * threads);
+}
+BENCHMARK(BM_Counter_ThreadChurn)->Arg(4)->Arg(16);
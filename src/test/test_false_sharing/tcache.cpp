@@ -1,7 +1,11 @@
 #include <benchmark/benchmark.h>
+#include <algorithm>
 #include <vector>
 #include <cstdint>
 
+#include "BenchCounters.h"
+#include "BenchPin.h"
+
 // ────────────────────────────────────────────────
 //  Part 1: 缓存局部性（行优先 vs 列优先）
 // ────────────────────────────────────────────────
@@ -12,6 +16,7 @@ static constexpr int M = 4096;
 static void BM_RowMajor(benchmark::State& state) {
     std::vector<std::vector<double>> mat(N, std::vector<double>(M, 1.0));
 
+    perf::BenchCounters perf_counters(state);
     for (auto _ : state) {
         double sum = 0;
         for (int i = 0; i < N; ++i) {
@@ -28,6 +33,7 @@ BENCHMARK(BM_RowMajor)->Unit(benchmark::kMillisecond);
 static void BM_ColumnMajor(benchmark::State& state) {
     std::vector<std::vector<double>> mat(N, std::vector<double>(M, 1.0));
 
+    perf::BenchCounters perf_counters(state);
     for (auto _ : state) {
         double sum = 0;
         for (int j = 0; j < M; ++j) {
@@ -45,15 +51,19 @@ BENCHMARK(BM_ColumnMajor)->Unit(benchmark::kMillisecond);
 //  Part 2: 伪共享（False Sharing） vs 避免伪共享
 // ────────────────────────────────────────────────
 
-static constexpr int THREADS = 16;
+// 数组按上限开，线程数取进程允许的 CPU 数（至少 2 个才有伪共享可言）
+static constexpr int MAX_THREADS = 256;
+static const int THREADS = std::clamp<int>(topo::default_threads(), 2, MAX_THREADS);
 static constexpr int ITER = 50'000'000;
 
 // 情况1：所有线程的计数器紧密排列 → 严重伪共享
 struct PaddedFalse {
-    int64_t counters[THREADS];
+    int64_t counters[MAX_THREADS];
 };
 static PaddedFalse data{};
 static void BM_FalseSharing(benchmark::State& state) {
+    auto pinned = topo::pin(state);
+    perf::BenchCounters perf_counters(state);
     for (auto _ : state) {
         auto& cnt = data.counters[state.thread_index()];
         for (int i = 0; i < ITER; ++i) {
@@ -72,9 +82,11 @@ struct alignas(64) Padder {
     int64_t value{};
     char padding[64 - sizeof(int64_t)];
 };
-alignas(64) Padder padData[THREADS];
+alignas(64) Padder padData[MAX_THREADS];
 
 static void BM_NoFalseSharing(benchmark::State& state) {
+    auto pinned = topo::pin(state);
+    perf::BenchCounters perf_counters(state);
     for (auto _ : state) {
         auto& cnt = padData[state.thread_index()].value;
         for (int i = 0; i < ITER; ++i) {
@@ -92,8 +104,10 @@ struct alignas(128) AlignedCounter {
     int64_t value{};
 };
 
-alignas(128) AlignedCounter counters[THREADS];
+alignas(128) AlignedCounter counters[MAX_THREADS];
 static void BM_128ByteAligned(benchmark::State& state) {
+    auto pinned = topo::pin(state);
+    perf::BenchCounters perf_counters(state);
     for (auto _ : state) {
         auto& cnt = counters[state.thread_index()].value;
         for (int i = 0; i < ITER; ++i) {
@@ -113,6 +127,8 @@ struct LocalValue {
 
 thread_local LocalValue LocalValue;
 static void BM_LocalValue(benchmark::State& state) {
+    auto pinned = topo::pin(state);
+    perf::BenchCounters perf_counters(state);
     for (auto _ : state) {
         auto& cnt =LocalValue.value;
         for (int i = 0; i < ITER; ++i) {
@@ -124,4 +140,4 @@ BENCHMARK(BM_LocalValue)->Threads(THREADS)
     ->Unit(benchmark::kMillisecond)
     ->Iterations(1);
 
-BENCHMARK_MAIN();
\ No newline at end of file
+TOPO_BENCHMARK_MAIN();
\ No newline at end of file
@@ -0,0 +1,339 @@
+#ifndef __HASHMAP_ConcurrentHashMap__
+#define __HASHMAP_ConcurrentHashMap__
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+
+#include <emmintrin.h>
+
+#include "RcuPtr.h"
+#include "ShardedCounter.h"
+
+// 并发开放寻址哈希表：fd -> 会话这类小键值，很多线程同时查、较少的线程增删。
+//
+//   布局  Swiss table：每 16 个槽位一组，每个槽位一个控制字节（EMPTY / DEAD / BUSY，或者存活时是哈希的低 7 位），
+//         一组的控制字节放在两个 64 位原子量里，查找时一次 SSE2 比较筛出候选槽位，组间线性探测
+//   读    不加锁：沿探测序列找控制字节匹配、键相等的存活槽位，遇到含 EMPTY 的组就停。
+//         表被 RcuPtr 保护，读的过程中被替换掉的旧表不会被释放
+//   写    按哈希分 STRIPES 个分片锁，同一个键的写互斥；不同键的写者用 CAS 抢 EMPTY 槽位（EMPTY -> BUSY），
+//         写好键值后再把控制字节改成哈希低 7 位发布。删除只把控制字节改成 DEAD，槽位在这张表里不再复用，
+//         所以一个槽位一旦发布，键就不会再变，读者比较键不需要额外的版本号
+//   扩容  已占用（含 DEAD）超过 7/8 时分配新表，挂到旧表的 next 上，之后每个写操作顺带搬 MIGRATE_CHUNK 组，
+//         最后一个搬完的写者把新表发布为当前表。迁移期间读者先查旧表、没找到再查新表，不会被挡住；
+//         一个键总是先放进新表再把旧表里的标成 DEAD，任意时刻最多有一处存活
+//
+// K、V 都要可平凡拷贝且不超过 8 字节（fd、句柄、指针）；键按字节比较。
+// 新建键时 used 计数是表内所有写者共享的原子量，只改值、删除、查找都不碰它
+template<typename K, typename V, typename Hash = std::hash<K>>
+class ConcurrentHashMap {
+    static_assert(std::is_trivially_copyable_v<K> && std::has_unique_object_representations_v<K> && sizeof(K) <= 8,
+                  "ConcurrentHashMap keys are compared bytewise and stored in 8 bytes");
+    static_assert(std::is_trivially_copyable_v<V> && sizeof(V) <= 8, "ConcurrentHashMap values are stored in 8 bytes");
+
+    static constexpr size_t GROUP = 16;
+    static constexpr uint8_t EMPTY = 0x80;
+    static constexpr uint8_t DEAD = 0xFE;  // 删除了，或者已经搬到新表
+    static constexpr uint8_t BUSY = 0xFF;  // 已经抢到，键值还没写完
+    static constexpr size_t NPOS = SIZE_MAX;
+
+    // 同时在抢槽位的写者不超过 STRIPES 个（抢槽位时都拿着分片锁），
+    // 最小容量的 1/8 至少留出这么多，迁移时往新表里搬的键总能放下
+    static constexpr unsigned STRIPES = 256;
+    static constexpr size_t MIN_CAPACITY = 8 * STRIPES;
+    static constexpr size_t MIGRATE_CHUNK = 2;
+
+    struct Slot {
+        std::atomic<uint64_t> key{0};
+        std::atomic<uint64_t> value{0};
+    };
+
+    // 读者通过 RcuPtr 拿到的是 const Table*，槽位和迁移状态都是要改的，放在指针后面或者标 mutable
+    struct Table {
+        Table(size_t groups, size_t reserve)
+            : mask(groups - 1), reserve(reserve), ctrl(new std::atomic<uint64_t>[2 * groups]),
+              slots(new Slot[groups * GROUP]) {
+            for (size_t i = 0; i < 2 * groups; ++i) {
+                ctrl[i].store(0x8080808080808080ull, std::memory_order_relaxed);
+            }
+        }
+
+        size_t groups() const { return mask + 1; }
+        size_t capacity() const { return groups() * GROUP; }
+
+        uint8_t byte(size_t i) const { return uint8_t(ctrl[i / 8].load(std::memory_order_seq_cst) >> (i % 8 * 8)); }
+
+        // 控制字节 from -> to，调用者保证它当前就是 from（持有该键的分片锁，或者是自己抢到的 BUSY）
+        void flip(size_t i, uint8_t from, uint8_t to) const {
+            ctrl[i / 8].fetch_xor(uint64_t(from ^ to) << (i % 8 * 8), std::memory_order_seq_cst);
+        }
+
+        const size_t mask;
+        const size_t reserve;  // 作为迁移目标时给旧表里的键预留的槽位数
+        const std::unique_ptr<std::atomic<uint64_t>[]> ctrl;
+        const std::unique_ptr<Slot[]> slots;
+        mutable std::atomic<size_t> used{0};
+        mutable std::atomic<Table*> next{nullptr};  // 迁移目标，设上后不再改
+        mutable std::atomic<size_t> cursor{0};      // 下一个待搬的组
+        mutable std::atomic<size_t> migrated{0};    // 已搬完的组数
+    };
+
+public:
+    explicit ConcurrentHashMap(size_t capacity = 0)
+        : tables_(std::make_unique<Table>(groups_for(std::max(capacity / 7 * 8, MIN_CAPACITY)), 0)) {}
+
+    ~ConcurrentHashMap() { delete tables_.read()->next.load(std::memory_order_relaxed); }
+
+    ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+    ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+
+    std::optional<V> find(const K& key) const {
+        const uint64_t k = to_word(key), h = hash_word(k);
+        auto guard = tables_.read();
+        const auto [t, i] = locate_chain(guard.get(), h, k);
+        if (!t) return std::nullopt;
+        return from_word<V>(t->slots[i].value.load(std::memory_order_acquire));
+    }
+
+    bool contains(const K& key) const { return find(key).has_value(); }
+
+    // 键不存在时插入，返回是否插入
+    bool insert(const K& key, const V& value) { return put(key, value, false); }
+
+    // 插入或覆盖，返回是否是新插入的
+    bool insert_or_assign(const K& key, const V& value) { return put(key, value, true); }
+
+    bool erase(const K& key) {
+        const uint64_t k = to_word(key), h = hash_word(k);
+        return write(h, [&](const Table* t0) -> Status {
+            const auto [t, i] = locate_chain(t0, h, k);
+            if (!t) return Status::SKIPPED;
+            t->flip(i, h2(h), DEAD);
+            size_.dec();
+            return Status::APPLIED;
+        }) == Status::APPLIED;
+    }
+
+    size_t size() const { return size_t(std::max<int64_t>(size_.value(), 0)); }
+
+    // 当前表的槽位数
+    size_t capacity() const { return tables_.read()->capacity(); }
+
+private:
+    // APPLIED / SKIPPED 是操作本身的布尔结果；GROW / WAIT 要放开锁和读区间之后重试
+    enum class Status { APPLIED, SKIPPED, GROW, WAIT };
+
+    bool put(const K& key, const V& value, bool assign) {
+        const uint64_t k = to_word(key), v = to_word(value), h = hash_word(k);
+        return write(h, [&](const Table* t0) -> Status {
+            const auto [t, i] = locate_chain(t0, h, k);
+            if (t) {
+                if (!assign) return Status::SKIPPED;
+                if (const Table* n = t->next.load(std::memory_order_seq_cst)) {
+                    // 旧表正在迁移：新值直接放进新表，再让旧表里的失效
+                    if (!place(n, h, k, v)) return Status::WAIT;
+                    t->flip(i, h2(h), DEAD);
+                } else {
+                    t->slots[i].value.store(v, std::memory_order_release);
+                }
+                return Status::SKIPPED;
+            }
+            const Table* tail = t0;
+            while (const Table* n = tail->next.load(std::memory_order_seq_cst)) {
+                tail = n;
+            }
+            // 当前表满了就由这个写者发起迁移；迁移目标满了只能等它成为当前表
+            const Status full = tail == t0 ? Status::GROW : Status::WAIT;
+            const size_t limit = tail->capacity() / 8 * 7 - (tail == t0 ? 0 : tail->reserve);
+            if (tail->used.load(std::memory_order_relaxed) >= limit) return full;
+            if (!place(tail, h, k, v)) return full;
+            size_.inc();
+            return Status::APPLIED;
+        }) == Status::APPLIED;
+    }
+
+    // 写操作的外壳：先帮忙迁移，再在分片锁下执行 op。
+    // 发布新表（要等宽限期）、发起迁移、等待都在放开分片锁之后做，等待时连读区间一起退出，
+    // 否则发布新表的那个写者会一直等这个读者
+    template<typename Op>
+    Status write(uint64_t h, Op&& op) {
+        while (true) {
+            Status status;
+            bool finished = false;
+            const Table* t0;
+            {
+                auto guard = tables_.read();
+                t0 = guard.get();
+                if (t0->next.load(std::memory_order_seq_cst)) finished = help_migrate(t0);
+                {
+                    std::lock_guard<std::mutex> lock(stripes_[h >> 56].mu);
+                    status = op(t0);
+                }
+                if (status == Status::GROW) start_migration(t0);
+            }
+            // t0 只有这里的 update 会释放
+            if (finished) tables_.update(std::unique_ptr<Table>(t0->next.load(std::memory_order_relaxed)));
+            if (status == Status::APPLIED || status == Status::SKIPPED) return status;
+            if (status == Status::WAIT) std::this_thread::yield();
+        }
+    }
+
+    // 调用者在读区间里，且 t 是当前表。新表按存活数的两倍加上旧容量的 1/8 取整，
+    // 给旧表里的键预留的槽位多算 STRIPES 个，覆盖取存活数之后才插进旧表的键
+    void start_migration(const Table* t) {
+        if (t->next.load(std::memory_order_relaxed)) return;
+        const size_t live = size() + STRIPES;
+        auto n = std::make_unique<Table>(groups_for(std::max(2 * live + t->capacity() / 8, MIN_CAPACITY)), live);
+        Table* expected = nullptr;
+        if (t->next.compare_exchange_strong(expected, n.get(), std::memory_order_seq_cst)) n.release();
+    }
+
+    // 领 MIGRATE_CHUNK 组搬到新表；搬完最后一组的写者返回 true，由它发布新表
+    bool help_migrate(const Table* t) {
+        const Table* n = t->next.load(std::memory_order_seq_cst);
+        const size_t begin = t->cursor.fetch_add(MIGRATE_CHUNK, std::memory_order_relaxed);
+        if (begin >= t->groups()) return false;
+        const size_t end = std::min(begin + MIGRATE_CHUNK, t->groups());
+        for (size_t g = begin; g < end; ++g) {
+            migrate_group(t, n, g);
+        }
+        return t->migrated.fetch_add(end - begin, std::memory_order_acq_rel) + (end - begin) == t->groups();
+    }
+
+    // 设上 next 之后才扫槽位，和写者"抢到槽位后再看 next"配对：扫到 EMPTY 的槽位之后被抢走的话，
+    // 抢到的写者一定看得到 next，会放弃它去新表；扫到 BUSY 就等写者发布或放弃
+    void migrate_group(const Table* t, const Table* n, size_t g) {
+        for (size_t i = g * GROUP; i < (g + 1) * GROUP; ++i) {
+            uint8_t b;
+            while ((b = t->byte(i)) == BUSY) {
+                _mm_pause();
+            }
+            if (b & 0x80) continue;
+            const uint64_t k = t->slots[i].key.load(std::memory_order_relaxed);
+            const uint64_t h = hash_word(k);
+            std::lock_guard<std::mutex> lock(stripes_[h >> 56].mu);
+            if (t->byte(i) != b) continue;  // 拿锁之前被删掉，或者被写者自己搬走了
+            place(n, h, k, t->slots[i].value.load(std::memory_order_relaxed));
+            t->flip(i, b, DEAD);
+        }
+    }
+
+    // 在 t 里占一个槽位并发布 (k, v)；占到之后发现 t 开始迁移了就放弃这个槽位，去迁移目标里放。
+    // 调用者持有 k 的分片锁。表满返回 nullptr
+    const Table* place(const Table* t, uint64_t h, uint64_t k, uint64_t v) {
+        while (t) {
+            const size_t i = claim(t, h);
+            if (i == NPOS) {
+                t = t->next.load(std::memory_order_seq_cst);
+                continue;
+            }
+            t->used.fetch_add(1, std::memory_order_relaxed);
+            if (const Table* n = t->next.load(std::memory_order_seq_cst)) {
+                t->flip(i, BUSY, DEAD);
+                t = n;
+                continue;
+            }
+            t->slots[i].key.store(k, std::memory_order_relaxed);
+            t->slots[i].value.store(v, std::memory_order_relaxed);
+            t->flip(i, BUSY, h2(h));
+            return t;
+        }
+        return nullptr;
+    }
+
+    // 抢探测序列上第一个含 EMPTY 的组里的空槽位（EMPTY -> BUSY）。
+    // 只往后挪到前面的组都没有 EMPTY 时，所以读者在第一个含 EMPTY 的组停下不会漏掉
+    static size_t claim(const Table* t, uint64_t h) {
+        size_t g = (h >> 7) & t->mask;
+        for (size_t probed = 0; probed <= t->mask; ++probed, g = (g + 1) & t->mask) {
+            while (true) {
+                const uint64_t lo = t->ctrl[2 * g].load(std::memory_order_relaxed);
+                const uint64_t hi = t->ctrl[2 * g + 1].load(std::memory_order_relaxed);
+                const unsigned empty = match(lo, hi, EMPTY);
+                if (!empty) break;
+                const unsigned j = std::countr_zero(empty);
+                uint64_t expected = j < 8 ? lo : hi;
+                if (t->ctrl[2 * g + j / 8].compare_exchange_strong(expected, expected | uint64_t(BUSY) << (j % 8 * 8),
+                                                                   std::memory_order_seq_cst)) {
+                    return g * GROUP + j;
+                }
+                // 这个字被别的写者改了，重读这一组
+            }
+        }
+        return NPOS;
+    }
+
+    // k 在 t 里存活的槽位
+    static size_t locate(const Table* t, uint64_t h, uint64_t k) {
+        size_t g = (h >> 7) & t->mask;
+        for (size_t probed = 0; probed <= t->mask; ++probed, g = (g + 1) & t->mask) {
+            // acquire：和发布时的 RMW 配对，匹配上的槽位键值已经写好
+            const uint64_t lo = t->ctrl[2 * g].load(std::memory_order_acquire);
+            const uint64_t hi = t->ctrl[2 * g + 1].load(std::memory_order_acquire);
+            for (unsigned m = match(lo, hi, h2(h)); m; m &= m - 1) {
+                const size_t i = g * GROUP + std::countr_zero(m);
+                if (t->slots[i].key.load(std::memory_order_relaxed) == k) return i;
+            }
+            if (match(lo, hi, EMPTY)) break;
+        }
+        return NPOS;
+    }
+
+    // 沿迁移链找 k：旧表里没有（或已搬走标成 DEAD）再看新表
+    static std::pair<const Table*, size_t> locate_chain(const Table* t, uint64_t h, uint64_t k) {
+        for (; t; t = t->next.load(std::memory_order_seq_cst)) {
+            const size_t i = locate(t, h, k);
+            if (i != NPOS) return {t, i};
+        }
+        return {nullptr, NPOS};
+    }
+
+    // 一组 16 个控制字节里等于 b 的位掩码
+    static unsigned match(uint64_t lo, uint64_t hi, uint8_t b) {
+        const __m128i ctrl = _mm_set_epi64x(int64_t(hi), int64_t(lo));
+        return unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(char(b)))));
+    }
+
+    static uint8_t h2(uint64_t h) { return uint8_t(h & 0x7F); }
+
+    // std::hash 对整数是恒等映射，乘一个奇常数再把高位折下来：低 7 位做 h2，中间的位选组，最高 8 位选分片
+    uint64_t hash_word(uint64_t k) const {
+        uint64_t h = uint64_t(hasher_(from_word<K>(k))) * 0x9E3779B97F4A7C15ull;
+        return h ^ (h >> 32);
+    }
+
+    static size_t groups_for(size_t slots) { return std::bit_ceil((slots + GROUP - 1) / GROUP); }
+
+    template<typename T>
+    static uint64_t to_word(const T& x) {
+        uint64_t w = 0;
+        memcpy(&w, &x, sizeof(T));
+        return w;
+    }
+
+    template<typename T>
+    static T from_word(uint64_t w) {
+        T x;
+        memcpy(&x, &w, sizeof(T));
+        return x;
+    }
+
+    struct alignas(stats::CACHE_LINE) Stripe {
+        std::mutex mu;
+    };
+
+    rcu::RcuPtr<Table> tables_;
+    static_assert(STRIPES == 256, "stripe index is the top byte of the hash");
+    std::unique_ptr<Stripe[]> stripes_{new Stripe[STRIPES]};
+    stats::ShardedGauge size_;
+    [[no_unique_address]] Hash hasher_;
+};
+
+#endif /* __HASHMAP_ConcurrentHashMap__ */
@@ -0,0 +1,161 @@
+#include "ConcurrentHashMap.h"
+#include <algorithm>
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include "BenchCounters.h"
+#include "BenchPin.h"
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// ────────────────────────────────────────────────
+//  会话表：fd -> 会话句柄。每个线程随机挑 fd，按 Arg 给的百分比做写
+//  （插入/覆盖和删除各一半，表的占用大致不变，删除留下的 DEAD 会周期性地触发原地迁移），其余是查找。
+//  值由 fd 算出来，查到的值对不上就报错
+// ────────────────────────────────────────────────
+
+constexpr int keySpace = 1 << 16;
+
+const int threadsNum = std::max(2u, topo::default_threads());
+
+static uint64_t session_of(int fd) { return uint64_t(fd) * 0x9E3779B97F4A7C15ull | 1; }
+
+// 对照组：一把互斥锁保护的 unordered_map
+class MutexMap {
+public:
+    std::optional<uint64_t> find(int fd) const {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = map_.find(fd);
+        if (it == map_.end()) return std::nullopt;
+        return it->second;
+    }
+    bool insert_or_assign(int fd, uint64_t session) {
+        std::lock_guard<std::mutex> lock(mu_);
+        return map_.insert_or_assign(fd, session).second;
+    }
+    bool erase(int fd) {
+        std::lock_guard<std::mutex> lock(mu_);
+        return map_.erase(fd) > 0;
+    }
+
+private:
+    mutable std::mutex mu_;
+    std::unordered_map<int, uint64_t> map_;
+};
+
+using SessionMap = ConcurrentHashMap<int, uint64_t>;
+
+// 预先放一半的 fd，所有线程数、读写比共用同一张表
+template<typename Map>
+static Map& sessions() {
+    static Map* map = [] {
+        auto* m = new Map;
+        for (int fd = 0; fd < keySpace; fd += 2) {
+            m->insert_or_assign(fd, session_of(fd));
+        }
+        return m;
+    }();
+    return *map;
+}
+
+// 迁移期间不丢键：从空表开始，几个写线程各插自己那份 fd（一路触发扩容迁移），每插四个删掉其中一个，
+// 另有一个线程一直在查。写线程都 join 之后逐个检查：该在的都在、值对，删掉的不在，size() 对得上
+static bool migration_check() {
+    constexpr int writers = 4;
+    constexpr int perWriter = 40000;
+    SessionMap map;
+    std::atomic<bool> writing{true};
+    std::atomic<size_t> bad{0};
+    std::thread reader([&] {
+        uint64_t x = 0x9E3779B97F4A7C15ull;
+        while (writing.load(std::memory_order_relaxed)) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            const int fd = int(x % (writers * perWriter));
+            auto session = map.find(fd);
+            if (session && *session != session_of(fd)) bad.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&map, w] {
+            for (int i = 0; i < perWriter; ++i) {
+                map.insert_or_assign(i * writers + w, session_of(i * writers + w));
+                if (i % 4 == 3) map.erase((i - 2) * writers + w);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    writing.store(false, std::memory_order_relaxed);
+    reader.join();
+
+    size_t expected = 0;
+    for (int i = 0; i < perWriter; ++i) {
+        const bool erased = i % 4 == 1 && i + 2 < perWriter;
+        for (int w = 0; w < writers; ++w) {
+            const int fd = i * writers + w;
+            auto session = map.find(fd);
+            if (erased ? session.has_value() : session != session_of(fd)) bad.fetch_add(1, std::memory_order_relaxed);
+        }
+        expected += erased ? 0 : writers;
+    }
+    return bad.load() == 0 && map.size() == expected;
+}
+
+template<typename Map>
+static void BM_SessionTable(benchmark::State& state) {
+    if constexpr (std::is_same_v<Map, SessionMap>) {
+        static const bool migrated_ok = migration_check();
+        if (state.thread_index() == 0 && !migrated_ok) {
+            state.SkipWithError("keys lost or misplaced across migration");
+        }
+    }
+    Map& map = sessions<Map>();
+    auto pinned = topo::pin(state);
+    perf::BenchCounters perf_counters(state);
+    const uint64_t writePercent = state.range(0);
+    uint64_t x = 0x9E3779B97F4A7C15ull * (state.thread_index() + 1);
+    size_t bad = 0;
+    for (auto _ : state) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        const int fd = int(x % keySpace);
+        if ((x >> 32) % 100 < writePercent) {
+            if (x & (1ull << 31)) {
+                map.insert_or_assign(fd, session_of(fd));
+            } else {
+                map.erase(fd);
+            }
+        } else {
+            auto session = map.find(fd);
+            bad += session && *session != session_of(fd);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (bad) state.SkipWithError("lookup returned another fd's session");
+}
+
+static const bool registered = [] {
+    auto add = [](const char* name, auto fn) {
+        benchmark::RegisterBenchmark(name, fn)
+            ->ArgName("write%")
+            ->Arg(0)
+            ->Arg(10)
+            ->Arg(50)
+            ->ThreadRange(1, threadsNum)
+            ->UseRealTime();
+    };
+    add("BM_SessionTable/mutex_unordered_map", BM_SessionTable<MutexMap>);
+    add("BM_SessionTable/concurrent", BM_SessionTable<SessionMap>);
+    return true;
+}();
+
+TOPO_BENCHMARK_MAIN();
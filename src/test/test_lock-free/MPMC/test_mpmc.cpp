@@ -1,21 +1,30 @@
 #include "MpmcRingBuffer.h"
+#include <algorithm>
 #include <atomic>
 #include <benchmark/benchmark.h>
+#include "BenchCounters.h"
+#include "BenchHistogram.h"
+#include "BenchPin.h"
+#include "Tsc.h"
 #include <cstddef>
 #include <cstdio>
 #include <iostream>
+#include <string>
 #include <thread>
 #include <unistd.h>
 
 constexpr size_t testSize = 1e7;
 
-const int threadsNum = std::thread::hardware_concurrency();
+// 一个生产者至少配一个消费者
+const int threadsNum = std::max(2u, topo::default_threads());
 
 MpmcRingBuffer<bool, (1 << 27)> spmc;
 std::atomic<size_t> popSuccessSum{0}; 
 std::atomic<size_t> putSuccessSum{0}; 
 
 static void BM_MpmcRingBuffer(benchmark::State& state) {
+    auto pinned = topo::pin(state);
+    perf::BenchCounters perf_counters(state);
     for (auto _ : state) {
         size_t successPut = 0;
         size_t successPop = 0;
@@ -38,6 +47,53 @@ static void BM_MpmcRingBuffer(benchmark::State& state) {
 }
 BENCHMARK(BM_MpmcRingBuffer)->Unit(benchmark::kMillisecond)->Iterations(1)->Threads(threadsNum);
 
+// ────────────────────────────────────────────────
+//  入队到出队的延迟：偶数线程把 TSC 时间戳当负载入队，奇数线程出队时记下差值，
+//  各消费者写自己的直方图分片。Arg 是每个生产者两次入队之间的间隔（ns），0 为满速
+// ────────────────────────────────────────────────
+
+constexpr int latencyBatch = 64;
+
+MpmcRingBuffer<uint64_t, 4096> stampQueue;
+stats::ShardedHistogram mpmcLatency;
+
+static void BM_MpmcLatency(benchmark::State& state) {
+    auto pinned = topo::pin(state);
+    const uint64_t gap = uint64_t(state.range(0) * stats::tsc_per_ns());
+    if ((state.thread_index() & 1) == 0) {
+        uint64_t next = stats::tsc_now();
+        for (auto _ : state) {
+            for (int i = 0; i < latencyBatch; ++i) {
+                uint64_t now;
+                while ((now = stats::tsc_now()) < next) {
+                }
+                next = now + gap;
+                while (!stampQueue.try_emplace(now)) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * latencyBatch);
+    } else {
+        // 循环开始前各线程之间有栅栏，别的消费者此时还没开始记录
+        if (state.thread_index() == 1) mpmcLatency.reset();
+        for (auto _ : state) {
+            for (int i = 0; i < latencyBatch; ++i) {
+                uint64_t stamp;
+                while (!stampQueue.try_pop(stamp)) {
+                    std::this_thread::yield();
+                }
+                mpmcLatency.record(stats::tsc_now() - stamp);
+            }
+        }
+        if (state.thread_index() == 1) {
+            stats::report(state, mpmcLatency.snapshot(), "mpmc_latency_" + std::to_string(state.threads()),
+                          stats::tsc_per_ns());
+        }
+    }
+}
+BENCHMARK(BM_MpmcLatency)->Threads(2)->Threads(4)->Arg(0)->Arg(1000)->UseRealTime();
+
 // 主函数
 int main(int argc, char **argv) {
     char arg0_default[] = "benchmark";
@@ -46,6 +102,7 @@ int main(int argc, char **argv) {
     argc = 1;
     argv = &args_default;
     }
+    topo::initialize(argc, argv);
     ::benchmark ::Initialize(&argc, argv);
     if (::benchmark ::ReportUnrecognizedArguments(argc, argv))
     return 1;
@@ -0,0 +1,84 @@
+#ifndef __RECLAIM_MsQueue__
+#define __RECLAIM_MsQueue__
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+#include "ShardedCounter.h"
+
+// Michael-Scott 无界队列：带哨兵节点的单链表，head_ 指向哨兵，tail_ 允许落后一步，由任何线程帮着推。
+// 出队后旧哨兵交给 Reclaim 延后释放。出队要同时护住 head 和 head->next 两个节点，用两个槽位
+template<typename T, typename Reclaim>
+class MsQueue {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        T value{};  // 链上之前写好，之后不变
+    };
+
+public:
+    static constexpr size_t NODE_BYTES = sizeof(Node);
+
+    MsQueue() {
+        Node* dummy = new Node;
+        head_.store(dummy, std::memory_order_relaxed);
+        tail_.store(dummy, std::memory_order_relaxed);
+    }
+    ~MsQueue() {
+        for (Node* n = head_.load(std::memory_order_relaxed); n;) {
+            Node* next = n->next.load(std::memory_order_relaxed);
+            delete n;
+            n = next;
+        }
+    }
+
+    MsQueue(const MsQueue&) = delete;
+    MsQueue& operator=(const MsQueue&) = delete;
+
+    void push(const T& value) {
+        Node* n = new Node;
+        n->value = value;
+        typename Reclaim::Guard guard;
+        for (;;) {
+            Node* tail = guard.protect(0, tail_);
+            Node* next = tail->next.load(std::memory_order_acquire);
+            if (tail != tail_.load(std::memory_order_acquire)) continue;
+            if (next) {
+                tail_.compare_exchange_weak(tail, next, std::memory_order_release, std::memory_order_relaxed);
+                continue;
+            }
+            if (tail->next.compare_exchange_weak(next, n, std::memory_order_release, std::memory_order_relaxed)) {
+                tail_.compare_exchange_strong(tail, n, std::memory_order_release, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+    bool try_pop(T& out) {
+        typename Reclaim::Guard guard;
+        for (;;) {
+            Node* head = guard.protect(0, head_);
+            Node* tail = tail_.load(std::memory_order_acquire);
+            Node* next = guard.protect(1, head->next);
+            if (head != head_.load(std::memory_order_acquire)) continue;
+            if (!next) return false;
+            if (head == tail) {
+                tail_.compare_exchange_weak(tail, next, std::memory_order_release, std::memory_order_relaxed);
+                continue;
+            }
+            const T value = next->value;
+            if (head_.compare_exchange_weak(head, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                out = value;
+                Reclaim::retire(head);
+                return true;
+            }
+        }
+    }
+
+private:
+    alignas(stats::CACHE_LINE) std::atomic<Node*> head_;
+    alignas(stats::CACHE_LINE) std::atomic<Node*> tail_;
+};
+
+#endif /* __RECLAIM_MsQueue__ */
@@ -0,0 +1,56 @@
+#ifndef __RECLAIM_TreiberStack__
+#define __RECLAIM_TreiberStack__
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+// Treiber 栈：head_ 上 CAS 入栈、出栈。弹出的节点交给 Reclaim（HazardPointers 或 Epoch）延后释放——
+// 别的线程可能刚读到它、正要读 next。受保护的节点不会被释放复用，所以也没有 ABA
+template<typename T, typename Reclaim>
+class TreiberStack {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    struct Node {
+        T value;
+        Node* next;  // 入栈前写好，之后不变
+    };
+
+public:
+    static constexpr size_t NODE_BYTES = sizeof(Node);
+
+    TreiberStack() = default;
+    ~TreiberStack() {
+        for (Node* n = head_.load(std::memory_order_relaxed); n;) {
+            Node* next = n->next;
+            delete n;
+            n = next;
+        }
+    }
+
+    TreiberStack(const TreiberStack&) = delete;
+    TreiberStack& operator=(const TreiberStack&) = delete;
+
+    void push(const T& value) {
+        Node* n = new Node{value, head_.load(std::memory_order_relaxed)};
+        while (!head_.compare_exchange_weak(n->next, n, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    bool try_pop(T& out) {
+        typename Reclaim::Guard guard;
+        for (;;) {
+            Node* head = guard.protect(0, head_);
+            if (!head) return false;
+            if (head_.compare_exchange_weak(head, head->next, std::memory_order_acquire, std::memory_order_relaxed)) {
+                out = head->value;
+                Reclaim::retire(head);
+                return true;
+            }
+        }
+    }
+
+private:
+    std::atomic<Node*> head_{nullptr};
+};
+
+#endif /* __RECLAIM_TreiberStack__ */
@@ -0,0 +1,169 @@
+#include "Epoch.h"
+#include "HazardPointers.h"
+#include "MsQueue.h"
+#include "TreiberStack.h"
+#include <algorithm>
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include "BenchCounters.h"
+#include "BenchPin.h"
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// ────────────────────────────────────────────────
+//  同一个 Treiber 栈 / Michael-Scott 队列分别配风险指针和纪元回收：
+//  每次迭代压入一个再弹出一个，结构里一直有 PREFILL 个左右的节点。
+//  0 号线程每 SAMPLE_EVERY 次迭代读一次未释放的节点数，报告峰值。
+//  stalled=1 时另有一个线程拿着 Guard 一直不放（读到一半被换下 CPU 的读者）：
+//  风险指针只扣住它登记的节点，纪元停住，之后退休的节点一个也放不掉——这组固定迭代次数，免得占满内存
+// ────────────────────────────────────────────────
+
+using reclaim::Epoch;
+using reclaim::HazardPointers;
+
+const int threadsNum = std::max(2u, topo::default_threads());
+
+constexpr int PREFILL = 1024;
+constexpr uint64_t SAMPLE_EVERY = 256;
+constexpr uint64_t STALLED_ITERATIONS = 1 << 20;
+
+// 值的高 16 位是标记，弹出的值标记不对说明读到了已经释放的节点
+constexpr uint64_t TAG = 0xC0DEull << 48;
+
+template<typename Structure>
+static Structure& shared() {
+    static Structure* s = [] {
+        auto* p = new Structure;
+        for (int i = 0; i < PREFILL; ++i) {
+            p->push(TAG | uint64_t(i));
+        }
+        return p;
+    }();
+    return *s;
+}
+
+// 进入 Guard 后睡到析构
+template<typename Scheme>
+class StalledReader {
+public:
+    StalledReader() : thread_([this] { run(); }) {
+        std::unique_lock<std::mutex> lock(mu_);
+        cv_.wait(lock, [this] { return entered_; });
+    }
+    ~StalledReader() {
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            done_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+
+private:
+    void run() {
+        typename Scheme::Guard guard;
+        std::unique_lock<std::mutex> lock(mu_);
+        entered_ = true;
+        cv_.notify_all();
+        cv_.wait(lock, [this] { return done_; });
+    }
+
+    std::mutex mu_;
+    std::condition_variable cv_;
+    bool entered_ = false;
+    bool done_ = false;
+    std::thread thread_;
+};
+
+// 线程的 Holder 析构之后，别的 thread_local 析构时还在用 Guard、还在 retire：
+// 对象不能丢，也不能拿着已经还回去的记录；之后别的线程 collect 几次应该都能放掉
+static std::atomic<int> exitFreed{0};
+
+struct Counted {
+    ~Counted() { exitFreed.fetch_add(1, std::memory_order_relaxed); }
+};
+
+template<typename Scheme>
+struct LateUser {
+    ~LateUser() {
+        std::atomic<Counted*> src{new Counted};
+        typename Scheme::Guard guard;
+        Scheme::retire(guard.protect(0, src));
+        Scheme::retire(new Counted);
+    }
+};
+
+template<typename Scheme>
+static bool exit_check() {
+    constexpr int THREADS = 16;
+    exitFreed.store(0);
+    for (int i = 0; i < THREADS; ++i) {
+        std::thread([] {
+            // 先构造，后析构：比 Scheme 的 Holder 晚
+            thread_local LateUser<Scheme> late;
+            Scheme::retire(new Counted);
+        }).join();
+    }
+    for (int i = 0; i < 4; ++i) {
+        Scheme::collect();
+    }
+    return exitFreed.load() == 3 * THREADS;
+}
+
+template<typename Scheme, template<typename, typename> class Structure>
+static void BM_PushPop(benchmark::State& state) {
+    auto& s = shared<Structure<uint64_t, Scheme>>();
+    std::unique_ptr<StalledReader<Scheme>> stalled;
+    if (state.thread_index() == 0) {
+        static const bool exit_ok = exit_check<Scheme>();
+        if (!exit_ok) state.SkipWithError("objects retired after thread exit were not reclaimed");
+        Scheme::collect();
+        Scheme::collect();
+        if (state.range(0)) stalled = std::make_unique<StalledReader<Scheme>>();
+    }
+    auto pinned = topo::pin(state);
+    perf::BenchCounters perf_counters(state);
+    uint64_t seq = 0;
+    int64_t peak = 0;
+    size_t bad = 0;
+    for (auto _ : state) {
+        s.push(TAG | seq);
+        uint64_t out = 0;
+        bad += !s.try_pop(out) || (out & ~0xFFFFFFFFFFFFull) != TAG;
+        if (state.thread_index() == 0 && ++seq % SAMPLE_EVERY == 0) {
+            peak = std::max(peak, Scheme::unreclaimed());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+    if (bad) state.SkipWithError("popped a value that was never pushed");
+    if (state.thread_index() == 0) {
+        peak = std::max(peak, Scheme::unreclaimed());
+        stalled.reset();
+        state.counters["peak_unreclaimed"] = double(peak);
+        state.counters["peak_bytes"] = benchmark::Counter(
+            double(peak * int64_t(Structure<uint64_t, Scheme>::NODE_BYTES)), benchmark::Counter::kDefaults,
+            benchmark::Counter::kIs1024);
+    }
+}
+
+static const bool registered = [] {
+    auto add = [](const char* name, auto fn) {
+        benchmark::RegisterBenchmark(name, fn)->ArgName("stalled")->Arg(0)->ThreadRange(1, threadsNum)->UseRealTime();
+        benchmark::RegisterBenchmark(name, fn)
+            ->ArgName("stalled")
+            ->Arg(1)
+            ->ThreadRange(1, threadsNum)
+            ->Iterations(STALLED_ITERATIONS)
+            ->UseRealTime();
+    };
+    add("BM_TreiberStack/hazard_pointers", BM_PushPop<HazardPointers, TreiberStack>);
+    add("BM_TreiberStack/epoch", BM_PushPop<Epoch, TreiberStack>);
+    add("BM_MsQueue/hazard_pointers", BM_PushPop<HazardPointers, MsQueue>);
+    add("BM_MsQueue/epoch", BM_PushPop<Epoch, MsQueue>);
+    return true;
+}();
+
+TOPO_BENCHMARK_MAIN();
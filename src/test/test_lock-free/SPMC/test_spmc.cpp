@@ -1,6 +1,9 @@
 #include "SpmcRingBuffer.h"
+#include <algorithm>
 #include <atomic>
 #include <benchmark/benchmark.h>
+#include "BenchCounters.h"
+#include "BenchPin.h"
 #include <cstddef>
 #include <cstdio>
 #include <iostream>
@@ -9,12 +12,15 @@
 
 constexpr size_t testSize = 1e7;
 
-const int threadsNum = std::thread::hardware_concurrency();
+// 一个生产者至少配一个消费者
+const int threadsNum = std::max(2u, topo::default_threads());
 
 SpmcRingBuffer<bool, (1 << 27)> spmc;
 std::atomic<size_t> popSuccessSum{0}; 
 
 static void BM_SpmcRingBuffer(benchmark::State& state) {
+    auto pinned = topo::pin(state);
+    perf::BenchCounters perf_counters(state);
     for (auto _ : state) {
         size_t successPut = 0;
         size_t successPop = 0;
@@ -46,6 +52,7 @@ int main(int argc, char **argv) {
     argc = 1;
     argv = &args_default;
     }
+    topo::initialize(argc, argv);
     ::benchmark ::Initialize(&argc, argv);
     if (::benchmark ::ReportUnrecognizedArguments(argc, argv))
     return 1;
@@ -1,6 +1,11 @@
 #include "SpscRingBuffer.h"
 #include <benchmark/benchmark.h>
+#include "BenchCounters.h"
+#include "BenchHistogram.h"
+#include "BenchPin.h"
+#include "Tsc.h"
 #include <iostream>
+#include <thread>
 #include <unistd.h>
 
 constexpr size_t testSize = 1e8;
@@ -8,6 +13,8 @@ constexpr size_t testSize = 1e8;
 SpscRingBuffer<int, (1 << 10)> spmc;
 
 static void BM_SpmcRingBuffer(benchmark::State& state) {
+    auto pinned = topo::pin(state);
+    perf::BenchCounters perf_counters(state);
     for (auto _ : state) {
         size_t successPut = 0;
         size_t successPop = 0;
@@ -30,5 +37,50 @@ static void BM_SpmcRingBuffer(benchmark::State& state) {
 }
 BENCHMARK(BM_SpmcRingBuffer)->Unit(benchmark::kMillisecond)->Iterations(1)->Threads(2);
 
+// ────────────────────────────────────────────────
+//  入队到出队的延迟：生产者把 TSC 时间戳当负载入队，消费者出队时记下差值。
+//  Arg 是生产者两次入队之间的间隔（ns）。0 为满速，队列一直是满的，量到的主要是排队时间；
+//  间隔够大时队列几乎总是空的，量到的是负载所在缓存行在两个核之间搬一次的代价，
+//  配合 --pin=llc-pairs / split-pairs 比较同 LLC 和跨 LLC / 跨 socket
+// ────────────────────────────────────────────────
+
+constexpr int latencyBatch = 64;
+
+SpscRingBuffer<uint64_t, (1 << 10)> stampQueue;
+stats::Histogram spscLatency;
+
+static void BM_SpscLatency(benchmark::State& state) {
+    auto pinned = topo::pin(state);
+    const uint64_t gap = uint64_t(state.range(0) * stats::tsc_per_ns());
+    if (state.thread_index() == 0) {
+        uint64_t next = stats::tsc_now();
+        for (auto _ : state) {
+            for (int i = 0; i < latencyBatch; ++i) {
+                uint64_t now;
+                while ((now = stats::tsc_now()) < next) {
+                }
+                next = now + gap;
+                while (!stampQueue.try_emplace(now)) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * latencyBatch);
+    } else {
+        spscLatency.reset();
+        for (auto _ : state) {
+            for (int i = 0; i < latencyBatch; ++i) {
+                uint64_t stamp;
+                while (!stampQueue.try_pop(stamp)) {
+                    std::this_thread::yield();
+                }
+                spscLatency.record(stats::tsc_now() - stamp);
+            }
+        }
+        stats::report(state, spscLatency.snapshot(), "spsc_latency", stats::tsc_per_ns());
+    }
+}
+BENCHMARK(BM_SpscLatency)->Threads(2)->Arg(0)->Arg(1000)->UseRealTime();
+
 // 主函数
-BENCHMARK_MAIN();
\ No newline at end of file
+TOPO_BENCHMARK_MAIN();
\ No newline at end of file
@@ -0,0 +1,227 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "BenchPin.h"
+#include "Kernels.h"
+#include "Matrix.h"
+
+// 连续存储 + 分块内核 vs test_false_sharing/tcache.cpp 里那种 vector<vector<double>>。
+// 嵌套 vector 每行单独分配，即使按行走也要先取行指针，行与行之间地址不连续，预取器每行都要重新起步
+
+using mat::Layout;
+using Nested = std::vector<std::vector<double>>;
+
+static constexpr size_t N = 4096;
+// 乘法是 O(n^3)，4096 时嵌套 vector 的版本要跑好几分钟，用较小的尺寸
+static constexpr size_t MUL_N = 1024;
+
+// 小整数，任何求和顺序下结果都精确，可以直接比较
+static double value_at(size_t i, size_t j) {
+    return double((i * 7 + j * 3) % 17) - 8;
+}
+
+static Nested make_nested(size_t rows, size_t cols) {
+    Nested m(rows, std::vector<double>(cols));
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < cols; ++j) {
+            m[i][j] = value_at(i, j);
+        }
+    }
+    return m;
+}
+
+template<Layout L>
+static mat::Matrix<double, L> make_matrix(size_t rows, size_t cols) {
+    mat::Matrix<double, L> m(rows, cols);
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < cols; ++j) {
+            m.at(i, j) = value_at(i, j);
+        }
+    }
+    return m;
+}
+
+// 行列数都不是块边长的倍数，覆盖补齐部分
+static constexpr size_t CHECK_ROWS = 100;
+static constexpr size_t CHECK_COLS = 70;
+
+template<Layout L>
+static bool check_transpose() {
+    auto a = make_matrix<L>(CHECK_ROWS, CHECK_COLS);
+    mat::Matrix<double, L> t(CHECK_COLS, CHECK_ROWS);
+    mat::transpose(a, t);
+    for (size_t i = 0; i < CHECK_ROWS; ++i) {
+        for (size_t j = 0; j < CHECK_COLS; ++j) {
+            if (t.at(j, i) != value_at(i, j)) return false;
+        }
+    }
+    return true;
+}
+
+template<Layout L>
+static bool check_column_sums() {
+    auto sums = mat::column_sums(make_matrix<L>(CHECK_ROWS, CHECK_COLS));
+    if (sums.size() != CHECK_COLS) return false;
+    for (size_t j = 0; j < CHECK_COLS; ++j) {
+        double expect = 0;
+        for (size_t i = 0; i < CHECK_ROWS; ++i) {
+            expect += value_at(i, j);
+        }
+        if (sums[j] != expect) return false;
+    }
+    return true;
+}
+
+template<Layout L>
+static bool check_multiply() {
+    auto a = make_matrix<L>(CHECK_ROWS, CHECK_COLS);
+    auto b = make_matrix<L>(CHECK_COLS, CHECK_ROWS);
+    mat::Matrix<double, L> c(CHECK_ROWS, CHECK_ROWS);
+    mat::multiply(a, b, c);
+    for (size_t i = 0; i < CHECK_ROWS; ++i) {
+        for (size_t j = 0; j < CHECK_ROWS; ++j) {
+            double expect = 0;
+            for (size_t k = 0; k < CHECK_COLS; ++k) {
+                expect += value_at(i, k) * value_at(k, j);
+            }
+            if (c.at(i, j) != expect) return false;
+        }
+    }
+    return true;
+}
+
+// ────────────────────────────────────────────────
+//  转置
+// ────────────────────────────────────────────────
+
+static void BM_Nested_Transpose(benchmark::State& state) {
+    Nested a = make_nested(N, N);
+    Nested t(N, std::vector<double>(N));
+    for (auto _ : state) {
+        for (size_t i = 0; i < N; ++i) {
+            for (size_t j = 0; j < N; ++j) {
+                t[j][i] = a[i][j];
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * 2 * N * N * sizeof(double));
+}
+BENCHMARK(BM_Nested_Transpose)->Unit(benchmark::kMillisecond);
+
+template<Layout L>
+static void BM_Transpose(benchmark::State& state) {
+    if (!check_transpose<L>()) {
+        state.SkipWithError("transpose mismatch");
+        return;
+    }
+    auto a = make_matrix<L>(N, N);
+    mat::Matrix<double, L> t(N, N);
+    for (auto _ : state) {
+        mat::transpose(a, t);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * 2 * N * N * sizeof(double));
+    state.SetLabel("tile=" + std::to_string(a.tile()));
+}
+BENCHMARK_TEMPLATE(BM_Transpose, Layout::RowMajor)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Transpose, Layout::Tiled)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Transpose, Layout::Morton)->Unit(benchmark::kMillisecond);
+
+// ────────────────────────────────────────────────
+//  列求和
+// ────────────────────────────────────────────────
+
+// 和 BM_ColumnMajor 一样一列一列地加
+static void BM_Nested_ColumnSums(benchmark::State& state) {
+    Nested a = make_nested(N, N);
+    std::vector<double> sums(N);
+    for (auto _ : state) {
+        for (size_t j = 0; j < N; ++j) {
+            double s = 0;
+            for (size_t i = 0; i < N; ++i) {
+                s += a[i][j];
+            }
+            sums[j] = s;
+        }
+        benchmark::DoNotOptimize(sums.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * N * N * sizeof(double));
+}
+BENCHMARK(BM_Nested_ColumnSums)->Unit(benchmark::kMillisecond);
+
+template<Layout L>
+static void BM_ColumnSums(benchmark::State& state) {
+    if (!check_column_sums<L>()) {
+        state.SkipWithError("column_sums mismatch");
+        return;
+    }
+    auto a = make_matrix<L>(N, N);
+    for (auto _ : state) {
+        auto sums = mat::column_sums(a);
+        benchmark::DoNotOptimize(sums.data());
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * N * N * sizeof(double));
+    state.SetLabel("tile=" + std::to_string(a.tile()));
+}
+BENCHMARK_TEMPLATE(BM_ColumnSums, Layout::RowMajor)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ColumnSums, Layout::Tiled)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ColumnSums, Layout::Morton)->Unit(benchmark::kMillisecond);
+
+// ────────────────────────────────────────────────
+//  乘法
+// ────────────────────────────────────────────────
+
+static void set_flops(benchmark::State& state, size_t n) {
+    state.counters["FLOP"] = benchmark::Counter(2.0 * double(n) * double(n) * double(n),
+                                                benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// 嵌套 vector 也按 i-k-j 顺序写（最内层沿行连续），只是不分块
+static void BM_Nested_Multiply(benchmark::State& state) {
+    Nested a = make_nested(MUL_N, MUL_N);
+    Nested b = make_nested(MUL_N, MUL_N);
+    Nested c(MUL_N, std::vector<double>(MUL_N));
+    for (auto _ : state) {
+        for (size_t i = 0; i < MUL_N; ++i) {
+            std::fill(c[i].begin(), c[i].end(), 0.0);
+            for (size_t k = 0; k < MUL_N; ++k) {
+                const double aik = a[i][k];
+                for (size_t j = 0; j < MUL_N; ++j) {
+                    c[i][j] += aik * b[k][j];
+                }
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    set_flops(state, MUL_N);
+}
+BENCHMARK(BM_Nested_Multiply)->Unit(benchmark::kMillisecond);
+
+template<Layout L>
+static void BM_Multiply(benchmark::State& state) {
+    if (!check_multiply<L>()) {
+        state.SkipWithError("multiply mismatch");
+        return;
+    }
+    const size_t n = size_t(state.range(0));
+    auto a = make_matrix<L>(n, n);
+    auto b = make_matrix<L>(n, n);
+    mat::Matrix<double, L> c(n, n);
+    for (auto _ : state) {
+        mat::multiply(a, b, c);
+        benchmark::ClobberMemory();
+    }
+    set_flops(state, n);
+    state.SetLabel("tile=" + std::to_string(a.tile()));
+}
+// 4096 单次要好几秒，只跑一轮
+BENCHMARK_TEMPLATE(BM_Multiply, Layout::RowMajor)->Arg(MUL_N)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Multiply, Layout::Tiled)->Arg(MUL_N)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Multiply, Layout::Morton)->Arg(MUL_N)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Multiply, Layout::Morton)->Arg(N)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+TOPO_BENCHMARK_MAIN();
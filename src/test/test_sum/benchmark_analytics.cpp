@@ -0,0 +1,162 @@
+#include <benchmark/benchmark.h>
+#include <x86intrin.h>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Analytics.h"
+
+// ────────────────────────────────────────────────
+//  分析类内核：min/max、argmax、前缀和、过滤压紧、直方图
+//  每个内核都先和 <algorithm> 写的参考结果对一遍，再计时；额外报告每个 TSC 周期处理的元素数
+// ────────────────────────────────────────────────
+
+// 和 data 一样是 std::vector<int>，但用随机值：全 1 的数组上过滤 / argmax 没有意义
+constexpr size_t COLUMN_SIZE = 1 << 24;  // 64MB，超出 LLC
+
+static const std::vector<int>& column() {
+    static std::vector<int> v = [] {
+        std::vector<int> c(COLUMN_SIZE);
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> dist(-1000000, 1000000);
+        for (auto& x : c) {
+            x = dist(rng);
+        }
+        return c;
+    }();
+    return v;
+}
+
+// 边界长度和非对齐起点，再加整列
+static std::vector<std::pair<size_t, size_t>> check_ranges() {
+    std::vector<std::pair<size_t, size_t>> ranges;
+    for (size_t n = 1; n < 70; ++n) {
+        ranges.push_back({n % 3, n});
+    }
+    ranges.push_back({0, COLUMN_SIZE});
+    return ranges;
+}
+
+template<typename Fn>
+static void run_timed(benchmark::State& state, Fn fn) {
+    uint64_t cycles = 0;
+    for (auto _ : state) {
+        uint64_t start = __rdtsc();
+        fn();
+        cycles += __rdtsc() - start;
+    }
+    state.SetItemsProcessed(state.iterations() * COLUMN_SIZE);
+    state.SetBytesProcessed(state.iterations() * COLUMN_SIZE * sizeof(int));
+    state.counters["elems/cycle"] = double(state.iterations()) * COLUMN_SIZE / cycles;
+}
+
+static void BM_MinMax(benchmark::State& state, const simd::AnalyticsKernels* k) {
+    const auto& c = column();
+    for (auto [off, n] : check_ranges()) {
+        auto [lo, hi] = std::minmax_element(c.begin() + off, c.begin() + off + n);
+        auto r = k->minmax(c.data() + off, n);
+        if (r.min != *lo || r.max != *hi) return state.SkipWithError("minmax mismatch");
+    }
+    run_timed(state, [&] {
+        auto r = k->minmax(c.data(), c.size());
+        benchmark::DoNotOptimize(r);
+    });
+}
+
+static void BM_ArgMax(benchmark::State& state, const simd::AnalyticsKernels* k) {
+    const auto& c = column();
+    for (auto [off, n] : check_ranges()) {
+        size_t expect = std::max_element(c.begin() + off, c.begin() + off + n) - (c.begin() + off);
+        if (k->argmax(c.data() + off, n) != expect) return state.SkipWithError("argmax mismatch");
+    }
+    run_timed(state, [&] {
+        auto r = k->argmax(c.data(), c.size());
+        benchmark::DoNotOptimize(r);
+    });
+}
+
+static void BM_InclusiveScan(benchmark::State& state, const simd::AnalyticsKernels* k) {
+    const auto& c = column();
+    std::vector<int> out(COLUMN_SIZE), expect(COLUMN_SIZE);
+    for (auto [off, n] : check_ranges()) {
+        uint32_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            acc += static_cast<uint32_t>(c[off + i]);
+            expect[i] = static_cast<int>(acc);
+        }
+        k->inclusive_scan(c.data() + off, out.data(), n);
+        if (!std::equal(out.begin(), out.begin() + n, expect.begin())) return state.SkipWithError("scan mismatch");
+    }
+    run_timed(state, [&] {
+        k->inclusive_scan(c.data(), out.data(), c.size());
+        benchmark::ClobberMemory();
+    });
+}
+
+// state.range(0) 为选中比例（百分比）；阈值取在值域上对应的位置
+static void BM_FilterGt(benchmark::State& state, const simd::AnalyticsKernels* k) {
+    const auto& c = column();
+    const int threshold = 1000000 - static_cast<int>(state.range(0)) * 20000;
+    std::vector<int> out(COLUMN_SIZE), expect;
+    for (auto [off, n] : check_ranges()) {
+        expect.clear();
+        std::copy_if(c.begin() + off, c.begin() + off + n, std::back_inserter(expect),
+                     [&](int v) { return v > threshold; });
+        size_t got = k->filter_gt(c.data() + off, n, threshold, out.data());
+        if (got != expect.size() || !std::equal(expect.begin(), expect.end(), out.begin())) {
+            return state.SkipWithError("filter mismatch");
+        }
+    }
+    run_timed(state, [&] {
+        size_t got = k->filter_gt(c.data(), c.size(), threshold, out.data());
+        benchmark::DoNotOptimize(got);
+        benchmark::ClobberMemory();
+    });
+}
+
+// state.range(0) 为桶数，覆盖整个值域
+static void BM_Histogram(benchmark::State& state, const simd::AnalyticsKernels* k) {
+    const auto& c = column();
+    const unsigned bins = state.range(0);
+    const int lo = -1000000;
+    unsigned shift = 0;
+    while ((2000001u >> shift) > bins) {
+        ++shift;
+    }
+    std::vector<uint32_t> counts(bins), expect(bins);
+    for (auto [off, n] : check_ranges()) {
+        std::fill(expect.begin(), expect.end(), 0);
+        for (size_t i = 0; i < n; ++i) {
+            uint32_t d = static_cast<uint32_t>(std::max(c[off + i], lo) - lo);
+            ++expect[std::min<uint32_t>(d >> shift, bins - 1)];
+        }
+        k->histogram(c.data() + off, n, lo, shift, counts.data(), bins);
+        if (counts != expect) return state.SkipWithError("histogram mismatch");
+    }
+    run_timed(state, [&] {
+        k->histogram(c.data(), c.size(), lo, shift, counts.data(), bins);
+        benchmark::ClobberMemory();
+    });
+}
+
+// 每个内核注册 scalar / avx2 两组，本机不支持 AVX2 时那组直接跳过
+static const int analytics_registered = [] {
+    for (simd::Isa isa : {simd::Isa::Scalar, simd::Isa::AVX2}) {
+        const simd::AnalyticsKernels* k = simd::analytics_kernels(isa);
+        std::string suffix = std::string("/") + simd::isa_name(isa);
+        auto reg = [&](const char* name, void (*fn)(benchmark::State&, const simd::AnalyticsKernels*)) {
+            return benchmark::RegisterBenchmark((name + suffix).c_str(), [fn, k](benchmark::State& state) {
+                if (!k) return state.SkipWithError("ISA not available on this host");
+                fn(state, k);
+            });
+        };
+        reg("BM_MinMax", BM_MinMax);
+        reg("BM_ArgMax", BM_ArgMax);
+        reg("BM_InclusiveScan", BM_InclusiveScan);
+        reg("BM_FilterGt", BM_FilterGt)->Arg(1)->Arg(50)->Arg(99);
+        reg("BM_Histogram", BM_Histogram)->Arg(16)->Arg(256);
+    }
+    return 0;
+}();
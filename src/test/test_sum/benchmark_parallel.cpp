@@ -0,0 +1,122 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <numeric>
+#include <thread>
+#include <version>
+#if defined(__cpp_lib_parallel_algorithm)
+#include <execution>
+#endif
+
+#include "ParallelReduce.h"
+#include "StreamKernels.h"
+#include "Topology.h"
+
+// ────────────────────────────────────────────────
+//  多线程求和：按线程数扫描，和 std::reduce(par_unseq) 对比
+// ────────────────────────────────────────────────
+
+constexpr size_t PARALLEL_SIZE = 1e8;  // 1e8 个 int32 ≈ 400MB
+
+// 直接用 aligned_alloc 申请、不做初始化，页由第一次写它的线程分配（first touch）
+struct RawBuffer {
+    explicit RawBuffer(size_t n)
+        : data(static_cast<int32_t*>(std::aligned_alloc(2 << 20, (n * sizeof(int32_t) + (2 << 20) - 1) & ~size_t((2 << 20) - 1)))) {}
+    ~RawBuffer() { std::free(data); }
+    int32_t* data;
+};
+
+static unsigned max_threads() {
+    return topo::default_threads();
+}
+
+// 本机读带宽的参照：不用被测的 parallel_sum，而是 test_bandwidth 的 stream::read（SSE2，每次一条缓存行、
+// 4 个累加器），全部线程各读自己那段同样大小的缓冲区，取 5 次里最好的一次
+static double stream_read_gbps() {
+    static double peak = [] {
+        simd::ThreadTeam team;
+        RawBuffer buf(PARALLEL_SIZE);
+        simd::parallel_fill(team, buf.data, PARALLEL_SIZE, [](size_t) { return 1; });
+        const char* bytes = reinterpret_cast<const char*>(buf.data);
+        double best = 0;
+        for (int rep = 0; rep < 5; ++rep) {
+            auto start = std::chrono::steady_clock::now();
+            team.run([&](unsigned index) {
+                size_t begin, end;
+                simd::thread_range<int32_t>(PARALLEL_SIZE, index, team.size(), begin, end);
+                const size_t len = ((end - begin) * sizeof(int32_t)) & ~(stream::LINE - 1);
+                benchmark::DoNotOptimize(stream::read(bytes + begin * sizeof(int32_t), len));
+            });
+            auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            best = std::max(best, PARALLEL_SIZE * sizeof(int32_t) / ns);
+        }
+        return best;
+    }();
+    return peak;
+}
+
+// elapsed_ns 为计时循环里实际流过的墙钟时间
+static void report(benchmark::State& state, double elapsed_ns) {
+    double bytes = double(state.iterations()) * PARALLEL_SIZE * sizeof(int32_t);
+    state.SetItemsProcessed(state.iterations() * PARALLEL_SIZE);
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    state.counters["GB/s"] = bytes / elapsed_ns;
+    state.counters["stream_read_GB/s"] = stream_read_gbps();
+    state.counters["of_stream_read"] = bytes / elapsed_ns / stream_read_gbps();
+}
+
+// state.range(0) 为线程数；每次都重新申请并由同一组线程初始化，保证页落在读它的线程所在节点
+static void BM_Sum_Parallel(benchmark::State& state) {
+    simd::ThreadTeam team(state.range(0));
+    RawBuffer buf(PARALLEL_SIZE);
+    simd::parallel_fill(team, buf.data, PARALLEL_SIZE, [](size_t) { return 1; });
+
+    int64_t sum = 0;
+    double elapsed_ns = 0;
+    for (auto _ : state) {
+        auto start = std::chrono::steady_clock::now();
+        sum = simd::parallel_sum(team, buf.data, PARALLEL_SIZE);
+        benchmark::DoNotOptimize(sum);
+        elapsed_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+    if (sum != int64_t(PARALLEL_SIZE)) {
+        state.SkipWithError("parallel sum mismatch");
+        return;
+    }
+    report(state, elapsed_ns);
+}
+
+// 1, 2, 4, ... 直到核数（核数本身也一定测到）
+static void thread_sweep(benchmark::internal::Benchmark* b) {
+    for (unsigned t = 1; t < max_threads(); t *= 2) {
+        b->Arg(t);
+    }
+    b->Arg(max_threads());
+}
+BENCHMARK(BM_Sum_Parallel)->Apply(thread_sweep)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_Sum_StdReduceParUnseq(benchmark::State& state) {
+#if defined(__cpp_lib_parallel_algorithm)
+    RawBuffer buf(PARALLEL_SIZE);
+    std::fill(std::execution::par_unseq, buf.data, buf.data + PARALLEL_SIZE, 1);
+
+    int64_t sum = 0;
+    double elapsed_ns = 0;
+    for (auto _ : state) {
+        auto start = std::chrono::steady_clock::now();
+        sum = std::reduce(std::execution::par_unseq, buf.data, buf.data + PARALLEL_SIZE, int64_t(0));
+        benchmark::DoNotOptimize(sum);
+        elapsed_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+    if (sum != int64_t(PARALLEL_SIZE)) {
+        state.SkipWithError("std::reduce mismatch");
+        return;
+    }
+    report(state, elapsed_ns);
+#else
+    state.SkipWithError("standard library has no parallel algorithms");
+#endif
+}
+BENCHMARK(BM_Sum_StdReduceParUnseq)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,92 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Reduce.h"
+
+// ────────────────────────────────────────────────
+//  simd 库的各 ISA 内核：每个等级单独一组，看每台机器实际能拿到什么
+// ────────────────────────────────────────────────
+
+// 1 << 24 个元素：int32 64MB / int64 128MB，远超 LLC
+constexpr size_t REDUCE_SIZE = 1 << 24;
+
+template<typename T>
+static const std::vector<T>& reduce_data() {
+    static std::vector<T> v = [] {
+        std::vector<T> d(REDUCE_SIZE);
+        for (size_t i = 0; i < d.size(); ++i) {
+            d[i] = static_cast<T>(i % 7) - 3;
+        }
+        return d;
+    }();
+    return v;
+}
+
+template<typename T>
+static auto kernel_of(const simd::SumKernels& k) {
+    if constexpr (std::is_same_v<T, int32_t>) return k.i32;
+    else if constexpr (std::is_same_v<T, int64_t>) return k.i64;
+    else if constexpr (std::is_same_v<T, float>) return k.f32;
+    else return k.f64;
+}
+
+// state.range(0) 为元素个数；从第 1 个元素开始，让内核走一遍非对齐的头部
+template<typename T>
+static void BM_Reduce(benchmark::State& state, simd::Isa isa) {
+    const simd::SumKernels* k = simd::sum_kernels(isa);
+    if (!k) {
+        state.SkipWithError("ISA not available on this host");
+        return;
+    }
+    const auto& d = reduce_data<T>();
+    const size_t n = state.range(0) - 1;
+    auto kernel = kernel_of<T>(*k);
+
+    auto expect = kernel_of<T>(*simd::sum_kernels(simd::Isa::Scalar))(d.data() + 1, n);
+    auto got = kernel(d.data() + 1, n);
+    if (std::abs(double(got) - double(expect)) > 1e-6 * (std::abs(double(expect)) + 1)) {
+        state.SkipWithError("result mismatch against scalar kernel");
+        return;
+    }
+
+    for (auto _ : state) {
+        auto sum = kernel(d.data() + 1, n);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetBytesProcessed(state.iterations() * n * sizeof(T));
+}
+
+template<typename T>
+static void register_reduce(const char* type) {
+    for (simd::Isa isa : {simd::Isa::Scalar, simd::Isa::SSE42, simd::Isa::AVX2, simd::Isa::AVX512}) {
+        std::string name = std::string("BM_Reduce<") + type + ">/" + simd::isa_name(isa);
+        benchmark::RegisterBenchmark(name.c_str(), BM_Reduce<T>, isa)->Arg(1 << 12)->Arg(REDUCE_SIZE);
+    }
+}
+
+static const int reduce_registered = [] {
+    register_reduce<int32_t>("int32_t");
+    register_reduce<int64_t>("int64_t");
+    register_reduce<float>("float");
+    register_reduce<double>("double");
+    return 0;
+}();
+
+// 自动分派：label 显示本机选中的等级（可用 SIMD_ISA 环境变量往下限制）
+static void BM_Reduce_Dispatch(benchmark::State& state) {
+    const auto& d = reduce_data<int32_t>();
+    for (auto _ : state) {
+        auto sum = simd::sum(d.data(), d.size());
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetLabel(simd::isa_name(simd::active_isa()));
+    state.SetItemsProcessed(state.iterations() * d.size());
+    state.SetBytesProcessed(state.iterations() * d.size() * sizeof(int32_t));
+}
+BENCHMARK(BM_Reduce_Dispatch);
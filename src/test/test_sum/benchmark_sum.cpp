@@ -3,6 +3,8 @@
 #include <immintrin.h>
 #include <vector>
 
+#include "BenchPin.h"
+
 // 数组大小（可通过 --benchmark_filter 调整或修改常量）
 constexpr size_t ARRAY_SIZE = 1e8;  // 1e8 个 int ≈ 800MB
 
@@ -50,7 +52,12 @@ static void BM_Sum_MultiAccum(benchmark::State& state) {
 BENCHMARK(BM_Sum_MultiAccum)->Unit(benchmark::kMillisecond)->Iterations(1);
 
 
-static void BM_Sum_AVX2_MultiAccum(benchmark::State& state) {
+// 只有这个函数用 AVX2 编译，其余代码保持基线指令集
+__attribute__((target("avx2"))) static void BM_Sum_AVX2_MultiAccum(benchmark::State& state) {
+    if (!__builtin_cpu_supports("avx2")) {
+        state.SkipWithError("AVX2 not supported on this host");
+        return;
+    }
 
     for (auto _ : state) {
         __m256i acc[6] = {};  // 256-bit 整数向量
@@ -98,4 +105,4 @@ static void BM_Sum_AVX2_MultiAccum(benchmark::State& state) {
 BENCHMARK(BM_Sum_AVX2_MultiAccum)->Unit(benchmark::kMillisecond)->Iterations(1);
 
 // 主函数
-BENCHMARK_MAIN();
\ No newline at end of file
+TOPO_BENCHMARK_MAIN();
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Autotune.h"
+
+// ────────────────────────────────────────────────
+//  累加器数 × 展开数的整张网格，看每台机器上的曲线；以及自动调优选中的结果
+// ────────────────────────────────────────────────
+
+// L1 内 4K 个元素，DRAM 上 1 << 24 个元素
+constexpr size_t GRID_SMALL = 1 << 12;
+constexpr size_t GRID_LARGE = 1 << 24;
+
+template<typename T>
+static const std::vector<T>& grid_data() {
+    static std::vector<T> v(GRID_LARGE, T(1));
+    return v;
+}
+
+template<typename T>
+static auto grid_kernel(const simd::SumKernels& k) {
+    if constexpr (std::is_same_v<T, int32_t>) return k.i32;
+    else return k.f64;
+}
+
+template<typename T>
+static void BM_SumGrid(benchmark::State& state, const simd::SumVariant* v) {
+    const auto& d = grid_data<T>();
+    const size_t n = state.range(0);
+    auto kernel = grid_kernel<T>(v->kernels);
+    if (kernel(d.data(), n) != static_cast<decltype(kernel(d.data(), n))>(n)) return state.SkipWithError("result mismatch");
+    for (auto _ : state) {
+        auto sum = kernel(d.data(), n);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetBytesProcessed(state.iterations() * n * sizeof(T));
+}
+
+template<typename T>
+static void register_grid(const char* type) {
+    for (simd::Isa isa : {simd::Isa::Scalar, simd::active_isa()}) {
+        for (const simd::SumVariant& v : simd::sum_variants(isa)) {
+            std::string name = std::string("BM_SumGrid<") + type + ">/" + simd::isa_name(isa) +
+                               "/acc:" + std::to_string(v.acc) + "/unroll:" + std::to_string(v.unroll);
+            benchmark::RegisterBenchmark(name.c_str(), BM_SumGrid<T>, &v)->Arg(GRID_SMALL)->Arg(GRID_LARGE);
+        }
+        if (isa == simd::active_isa()) break;
+    }
+}
+
+// 第一次运行时会先调优（并写 profile），之后的计时只是查表 + 间接调用
+template<typename T>
+static void BM_SumTuned(benchmark::State& state) {
+    const auto& d = grid_data<T>();
+    const size_t n = state.range(0);
+    if (simd::tuned_sum(d.data(), n) != static_cast<decltype(simd::tuned_sum(d.data(), n))>(n)) return state.SkipWithError("result mismatch");
+    for (auto _ : state) {
+        auto sum = simd::tuned_sum(d.data(), n);
+        benchmark::DoNotOptimize(sum);
+    }
+    const auto& v = simd::tuned_variant(std::is_same_v<T, int32_t> ? simd::ElemType::I32 : simd::ElemType::F64,
+                                        simd::size_class(n * sizeof(T)));
+    state.SetLabel(std::string(simd::isa_name(simd::active_isa())) + " acc=" + std::to_string(v.acc) +
+                   " unroll=" + std::to_string(v.unroll));
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetBytesProcessed(state.iterations() * n * sizeof(T));
+}
+
+static const int grid_registered = [] {
+    register_grid<int32_t>("int32_t");
+    register_grid<double>("double");
+    benchmark::RegisterBenchmark("BM_SumTuned<int32_t>", BM_SumTuned<int32_t>)->Arg(GRID_SMALL)->Arg(GRID_LARGE);
+    benchmark::RegisterBenchmark("BM_SumTuned<double>", BM_SumTuned<double>)->Arg(GRID_SMALL)->Arg(GRID_LARGE);
+    return 0;
+}();
@@ -0,0 +1,39 @@
+#ifndef __TOPO_BENCHPIN__
+#define __TOPO_BENCHPIN__
+#include <benchmark/benchmark.h>
+
+#include "Topology.h"
+
+// 把绑核策略接到 Google Benchmark 上：
+//   TOPO_BENCHMARK_MAIN() 代替 BENCHMARK_MAIN()，先取走 --pin=<策略>，再把策略和拓扑写进输出的 context；
+//   自己写 main 的基准在 benchmark::Initialize 之前调用 topo::initialize(argc, argv)。
+//   多线程基准在函数开头写 auto pinned = topo::pin(state);，第 thread_index 个基准线程按策略绑核，
+//   函数返回时解除（0 号基准线程就是主线程）
+namespace topo {
+
+inline void initialize(int& argc, char** argv) {
+    parse_args(argc, argv);
+    benchmark::AddCustomContext("pin", policy_name(policy()));
+    benchmark::AddCustomContext("topology", Topology::get().describe());
+}
+
+[[nodiscard]] inline ScopedPin pin(benchmark::State& state) {
+    return ScopedPin(unsigned(state.thread_index()), unsigned(state.threads()));
+}
+
+}  // namespace topo
+
+#define TOPO_BENCHMARK_MAIN()                                         \
+    int main(int argc, char** argv) {                                 \
+        topo::initialize(argc, argv);                                 \
+        ::benchmark::Initialize(&argc, argv);                         \
+        if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {   \
+            return 1;                                                 \
+        }                                                             \
+        ::benchmark::RunSpecifiedBenchmarks();                        \
+        ::benchmark::Shutdown();                                      \
+        return 0;                                                     \
+    }                                                                 \
+    int main(int, char**)
+
+#endif /* __TOPO_BENCHPIN__ */
@@ -0,0 +1,101 @@
+#ifndef __TOPO_TOPOLOGY__
+#define __TOPO_TOPOLOGY__
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// CPU 拓扑和绑核策略。
+//
+// 拓扑从 /sys/devices/system/cpu 和 /sys/devices/system/node 读出：每个 CPU 属于哪个物理核
+// （SMT 兄弟共用一个核）、哪个 LLC 域（共享最后一级缓存的 CPU）、哪个 NUMA 节点和 socket。
+// 只列出进程允许运行的 CPU（尊重 taskset / cgroup）。sysfs 缺项时退化为每个 CPU 自成一核、
+// 全部在一个 LLC / 节点 / socket 里。
+//
+// 策略把"第 i 个线程（共 n 个）"映射到一个 CPU，超出 CPU 数时绕回：
+//   none        不绑核（默认）
+//   compact     依次占满同一个核的 SMT 兄弟、同一个 LLC、同一个节点，线程之间离得最近
+//   scatter     依次轮流落到不同 socket / 节点 / LLC / 物理核上，线程之间离得最远
+//   cores       每个物理核一个线程，不用 SMT 兄弟（核用完之后才用）
+//   llc-pairs   (0,1)、(2,3)…… 每对在同一个 LLC 域的两个不同物理核上，测同一 LLC 内的队列开销
+//   split-pairs 每对的两个线程在不同 LLC 域（多 socket 时在不同 socket）上，测跨 LLC / 跨 socket 的开销
+//
+// 基准和服务程序在 main 开头调用 parse_args，从命令行取 --pin=<策略>（也可用环境变量 HPP_PIN），
+// 之后线程调用 pin_current(index, n) 按全局策略绑核
+namespace topo {
+
+struct Cpu {
+    unsigned id;
+    unsigned core;     // 物理核：同核 SMT 兄弟里编号最小的 CPU
+    unsigned smt;      // 在同核兄弟里的序号，0 为第一个
+    unsigned llc;      // LLC 域：共享 LLC 的 CPU 里编号最小的那个
+    unsigned node;     // NUMA 节点
+    unsigned package;  // socket
+};
+
+class Topology {
+public:
+    // 本进程的拓扑，第一次调用时读 sysfs
+    static const Topology& get();
+
+    // root 是 sysfs 里 devices/system 的路径，便于用假目录树测试；allowed 为空时取 sched_getaffinity
+    static Topology discover(const std::string& root = "/sys/devices/system", std::vector<unsigned> allowed = {});
+
+    const std::vector<Cpu>& cpus() const { return cpus_; }
+    unsigned cores() const;
+    unsigned llcs() const;
+    unsigned nodes() const;
+    unsigned packages() const;
+
+    // 例如 "8 cpus, 4 cores, 1 llc, 1 node, 1 package"
+    std::string describe() const;
+
+private:
+    std::vector<Cpu> cpus_;  // 按 CPU 编号升序
+};
+
+enum class Policy { None, Compact, Scatter, Cores, LlcPairs, SplitPairs };
+
+const char* policy_name(Policy policy);
+bool parse_policy(std::string_view name, Policy& out);
+
+// 按策略给 n 个线程排出 CPU 编号；None 时返回空
+std::vector<unsigned> plan(const Topology& topo, Policy policy, unsigned threads);
+
+// 进程级的策略
+void set_policy(Policy policy);
+Policy policy();
+
+// 从 argv 里取出并删掉 --pin=<策略>，没有时看环境变量 HPP_PIN；策略名不认识时打印可选值并退出
+void parse_args(int& argc, char** argv);
+
+// 进程允许运行的 CPU 数，替代 hardware_concurrency()
+unsigned default_threads();
+
+// 按进程级策略，第 index 个线程（共 threads 个）应绑的 CPU；不绑时返回 -1
+int cpu_for(unsigned index, unsigned threads);
+
+// 绑当前线程 / 指定线程，成功返回 true
+bool pin_current_to(unsigned cpu);
+bool pin_to(std::thread& t, unsigned cpu);
+
+// 按进程级策略绑当前线程，策略为 none 时什么也不做
+void pin_current(unsigned index, unsigned threads);
+
+// 同上，但只在作用域内有效，析构时恢复原来的亲和性。给借用的线程用（例如 Google Benchmark
+// 的 0 号线程就是主线程），免得之后在这个线程上跑的东西、从它派生的线程都被钉在一个 CPU 上
+class ScopedPin {
+public:
+    ScopedPin(unsigned index, unsigned threads);
+    ~ScopedPin();
+
+    ScopedPin(const ScopedPin&) = delete;
+    ScopedPin& operator=(const ScopedPin&) = delete;
+
+private:
+    std::vector<unsigned> saved_;  // 为空表示没有绑
+};
+
+}  // namespace topo
+
+#endif /* __TOPO_TOPOLOGY__ */
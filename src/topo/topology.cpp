@@ -0,0 +1,366 @@
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <tuple>
+
+#include "Topology.h"
+
+namespace topo {
+
+namespace {
+
+std::string read_line(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+unsigned read_unsigned(const std::string& path, unsigned fallback) {
+    std::string s = read_line(path);
+    if (s.empty()) return fallback;
+    char* end = nullptr;
+    long v = strtol(s.c_str(), &end, 10);
+    return end != s.c_str() && v >= 0 ? unsigned(v) : fallback;
+}
+
+// sysfs 的 CPU 列表格式："0-3,8,10-11"
+std::vector<unsigned> parse_cpu_list(const std::string& s) {
+    std::vector<unsigned> cpus;
+    std::stringstream ss(s);
+    std::string part;
+    while (std::getline(ss, part, ',')) {
+        unsigned lo, hi;
+        if (sscanf(part.c_str(), "%u-%u", &lo, &hi) == 2) {
+            for (unsigned c = lo; c <= hi; ++c) {
+                cpus.push_back(c);
+            }
+        } else if (sscanf(part.c_str(), "%u", &lo) == 1) {
+            cpus.push_back(lo);
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    return cpus;
+}
+
+std::vector<unsigned> affinity_cpus() {
+    std::vector<unsigned> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (unsigned c = 0; c < CPU_SETSIZE; ++c) {
+            if (CPU_ISSET(c, &set)) cpus.push_back(c);
+        }
+    }
+    return cpus;
+}
+
+// 共享最后一级数据 / 统一缓存的 CPU 里编号最小的；读不到缓存信息时返回 fallback
+unsigned llc_of(const std::string& cpu_dir, unsigned fallback) {
+    std::error_code ec;
+    unsigned best_level = 0;
+    unsigned llc = fallback;
+    for (const auto& entry : std::filesystem::directory_iterator(cpu_dir + "/cache", ec)) {
+        const std::string dir = entry.path().string();
+        if (entry.path().filename().string().rfind("index", 0) != 0) continue;
+        if (read_line(dir + "/type") == "Instruction") continue;
+        unsigned level = read_unsigned(dir + "/level", 0);
+        auto shared = parse_cpu_list(read_line(dir + "/shared_cpu_list"));
+        if (level > best_level && !shared.empty()) {
+            best_level = level;
+            llc = shared.front();
+        }
+    }
+    return llc;
+}
+
+std::map<unsigned, unsigned> node_map(const std::string& root) {
+    std::map<unsigned, unsigned> node_of;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(root + "/node", ec)) {
+        const std::string name = entry.path().filename().string();
+        unsigned node;
+        if (sscanf(name.c_str(), "node%u", &node) != 1) continue;
+        for (unsigned c : parse_cpu_list(read_line(entry.path().string() + "/cpulist"))) {
+            node_of[c] = node;
+        }
+    }
+    return node_of;
+}
+
+template<typename Key>
+unsigned count_distinct(const std::vector<Cpu>& cpus, Key key) {
+    std::set<unsigned> s;
+    for (const auto& c : cpus) {
+        s.insert(key(c));
+    }
+    return unsigned(s.size());
+}
+
+// 在 parent 相同的 CPU 里，child 值的名次（按升序去重）
+template<typename Parent, typename Child>
+std::map<unsigned, unsigned> rank_within(const std::vector<Cpu>& cpus, Parent parent, Child child) {
+    std::map<unsigned, std::set<unsigned>> children;
+    for (const auto& c : cpus) {
+        children[parent(c)].insert(child(c));
+    }
+    std::map<unsigned, unsigned> out;
+    for (const auto& c : cpus) {
+        const auto& set = children[parent(c)];
+        out[c.id] = unsigned(std::distance(set.begin(), set.find(child(c))));
+    }
+    return out;
+}
+
+std::vector<Cpu> compact_order(std::vector<Cpu> cpus) {
+    std::sort(cpus.begin(), cpus.end(), [](const Cpu& a, const Cpu& b) {
+        return std::tie(a.package, a.node, a.llc, a.core, a.smt) < std::tie(b.package, b.node, b.llc, b.core, b.smt);
+    });
+    return cpus;
+}
+
+// 字典序最后一维变得最快：相邻两项优先落在不同 socket，其次不同节点、不同 LLC、不同核
+std::vector<Cpu> scatter_order(std::vector<Cpu> cpus) {
+    auto core_rank = rank_within(cpus, [](const Cpu& c) { return c.llc; }, [](const Cpu& c) { return c.core; });
+    auto llc_rank = rank_within(cpus, [](const Cpu& c) { return c.node; }, [](const Cpu& c) { return c.llc; });
+    auto node_rank = rank_within(cpus, [](const Cpu& c) { return c.package; }, [](const Cpu& c) { return c.node; });
+    auto key = [&](const Cpu& c) {
+        return std::make_tuple(c.smt, core_rank[c.id], llc_rank[c.id], node_rank[c.id], c.package);
+    };
+    std::sort(cpus.begin(), cpus.end(), [&](const Cpu& a, const Cpu& b) { return key(a) < key(b); });
+    return cpus;
+}
+
+std::vector<unsigned> llc_pairs(const std::vector<Cpu>& cpus) {
+    std::map<unsigned, std::vector<Cpu>> domains;
+    for (const auto& c : compact_order(cpus)) {
+        domains[c.llc].push_back(c);
+    }
+    std::vector<unsigned> order;
+    for (auto& [llc, members] : domains) {
+        // 先用各核的第一个 SMT 线程，让一对落在两个不同的物理核上
+        std::stable_sort(members.begin(), members.end(), [](const Cpu& a, const Cpu& b) { return a.smt < b.smt; });
+        if (members.size() == 1) {
+            order.push_back(members[0].id);
+            order.push_back(members[0].id);
+            continue;
+        }
+        for (size_t i = 0; i + 1 < members.size(); i += 2) {
+            order.push_back(members[i].id);
+            order.push_back(members[i + 1].id);
+        }
+    }
+    return order;
+}
+
+std::atomic<Policy> g_policy{Policy::None};
+
+constexpr Policy ALL_POLICIES[] = {Policy::None, Policy::Compact, Policy::Scatter,
+                                   Policy::Cores, Policy::LlcPairs, Policy::SplitPairs};
+
+}  // namespace
+
+const Topology& Topology::get() {
+    static const Topology t = discover();
+    return t;
+}
+
+Topology Topology::discover(const std::string& root, std::vector<unsigned> allowed) {
+    if (allowed.empty()) allowed = affinity_cpus();
+    if (allowed.empty()) allowed = parse_cpu_list(read_line(root + "/cpu/online"));
+    if (allowed.empty()) {
+        for (unsigned c = 0; c < std::max(1u, std::thread::hardware_concurrency()); ++c) {
+            allowed.push_back(c);
+        }
+    }
+    const auto node_of = node_map(root);
+
+    Topology t;
+    for (unsigned id : allowed) {
+        const std::string dir = root + "/cpu/cpu" + std::to_string(id);
+        auto siblings = parse_cpu_list(read_line(dir + "/topology/thread_siblings_list"));
+        if (std::find(siblings.begin(), siblings.end(), id) == siblings.end()) siblings = {id};
+        Cpu c;
+        c.id = id;
+        c.core = siblings.front();
+        c.smt = unsigned(std::find(siblings.begin(), siblings.end(), id) - siblings.begin());
+        c.package = read_unsigned(dir + "/topology/physical_package_id", 0);
+        c.llc = llc_of(dir, 0);
+        auto it = node_of.find(id);
+        c.node = it == node_of.end() ? 0 : it->second;
+        t.cpus_.push_back(c);
+    }
+    std::sort(t.cpus_.begin(), t.cpus_.end(), [](const Cpu& a, const Cpu& b) { return a.id < b.id; });
+    return t;
+}
+
+unsigned Topology::cores() const {
+    return count_distinct(cpus_, [](const Cpu& c) { return c.core; });
+}
+unsigned Topology::llcs() const {
+    return count_distinct(cpus_, [](const Cpu& c) { return c.llc; });
+}
+unsigned Topology::nodes() const {
+    return count_distinct(cpus_, [](const Cpu& c) { return c.node; });
+}
+unsigned Topology::packages() const {
+    return count_distinct(cpus_, [](const Cpu& c) { return c.package; });
+}
+
+std::string Topology::describe() const {
+    auto plural = [](unsigned n, const char* word) {
+        return std::to_string(n) + " " + word + (n == 1 ? "" : "s");
+    };
+    return plural(unsigned(cpus_.size()), "cpu") + ", " + plural(cores(), "core") + ", " + plural(llcs(), "llc") +
+           ", " + plural(nodes(), "node") + ", " + plural(packages(), "package");
+}
+
+const char* policy_name(Policy policy) {
+    switch (policy) {
+        case Policy::None: return "none";
+        case Policy::Compact: return "compact";
+        case Policy::Scatter: return "scatter";
+        case Policy::Cores: return "cores";
+        case Policy::LlcPairs: return "llc-pairs";
+        case Policy::SplitPairs: return "split-pairs";
+    }
+    return "?";
+}
+
+bool parse_policy(std::string_view name, Policy& out) {
+    for (Policy p : ALL_POLICIES) {
+        if (name == policy_name(p)) {
+            out = p;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<unsigned> plan(const Topology& topo, Policy policy, unsigned threads) {
+    std::vector<unsigned> order;
+    switch (policy) {
+        case Policy::None: return {};
+        case Policy::Compact:
+            for (const auto& c : compact_order(topo.cpus())) {
+                order.push_back(c.id);
+            }
+            break;
+        case Policy::Cores: {
+            auto cpus = compact_order(topo.cpus());
+            std::stable_sort(cpus.begin(), cpus.end(), [](const Cpu& a, const Cpu& b) { return a.smt < b.smt; });
+            for (const auto& c : cpus) {
+                order.push_back(c.id);
+            }
+            break;
+        }
+        // 散开排列时相邻两项已经尽量在不同的 socket / LLC 上，按 (0,1)、(2,3) 分对即可
+        case Policy::Scatter:
+        case Policy::SplitPairs:
+            for (const auto& c : scatter_order(topo.cpus())) {
+                order.push_back(c.id);
+            }
+            break;
+        case Policy::LlcPairs: order = llc_pairs(topo.cpus()); break;
+    }
+    if (order.empty()) return {};
+    std::vector<unsigned> out(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        out[i] = order[i % order.size()];
+    }
+    return out;
+}
+
+void set_policy(Policy policy) {
+    g_policy.store(policy, std::memory_order_relaxed);
+}
+
+Policy policy() {
+    return g_policy.load(std::memory_order_relaxed);
+}
+
+void parse_args(int& argc, char** argv) {
+    const char* value = nullptr;
+    int out = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--pin=", 6) == 0) {
+            value = argv[i] + 6;
+        } else {
+            argv[out++] = argv[i];
+        }
+    }
+    if (out < argc) argv[out] = nullptr;
+    argc = out;
+    if (!value) value = getenv("HPP_PIN");
+    if (!value || !*value) return;
+
+    Policy p;
+    if (!parse_policy(value, p)) {
+        fprintf(stderr, "unknown pin policy '%s', expected one of:", value);
+        for (Policy q : ALL_POLICIES) {
+            fprintf(stderr, " %s", policy_name(q));
+        }
+        fprintf(stderr, "\n");
+        exit(2);
+    }
+    set_policy(p);
+}
+
+unsigned default_threads() {
+    return std::max<unsigned>(1, unsigned(Topology::get().cpus().size()));
+}
+
+int cpu_for(unsigned index, unsigned threads) {
+    if (policy() == Policy::None || threads == 0) return -1;
+    auto cpus = plan(Topology::get(), policy(), threads);
+    return cpus.empty() ? -1 : int(cpus[index % threads]);
+}
+
+static bool set_affinity(pthread_t t, unsigned cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(t, sizeof(set), &set) == 0;
+}
+
+bool pin_current_to(unsigned cpu) {
+    return set_affinity(pthread_self(), cpu);
+}
+
+bool pin_to(std::thread& t, unsigned cpu) {
+    return set_affinity(t.native_handle(), cpu);
+}
+
+void pin_current(unsigned index, unsigned threads) {
+    int cpu = cpu_for(index, threads);
+    if (cpu >= 0) pin_current_to(unsigned(cpu));
+}
+
+ScopedPin::ScopedPin(unsigned index, unsigned threads) {
+    int cpu = cpu_for(index, threads);
+    if (cpu < 0) return;
+    saved_ = affinity_cpus();
+    if (!pin_current_to(unsigned(cpu))) saved_.clear();
+}
+
+ScopedPin::~ScopedPin() {
+    if (saved_.empty()) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (unsigned c : saved_) {
+        CPU_SET(c, &set);
+    }
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+}  // namespace topo